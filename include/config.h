@@ -673,6 +673,15 @@ typedef unsigned char uchar;
 #define EXTRA_SANITY_CHECKS
 #endif
 
+/* HOTPATH_PROFILING adds timers and call counters around the main phases
+ * of moveloop_core() (movemon, timers, regions, vision, status, screen
+ * flushing), level creation, and save/restore.  The wizard mode
+ * #wizprofile command shows them.  If NH_PROFILELOG is set in the
+ * environment, a line of JSON with the figures for the interval is
+ * appended to that file every NH_PROFILEINTERVAL turns (default 1000)
+ * and at the end of the game. */
+/* #define HOTPATH_PROFILING */
+
 /* BREADCRUMBS employs the use of predefined compiler macros
  * __FUNCTION__ and __LINE__ to store some caller breadcrumbs
  * for use during heavy debugging sessions. Only define if your
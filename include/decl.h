@@ -64,6 +64,9 @@ extern const char *fqn_prefix_names[PREFIX_COUNT];
 extern NEARDATA boolean has_strong_rngseed;
 extern struct engr *head_engr;
 
+/* allocation pools for objects, monsters, and their extensions */
+extern struct nhpool obj_pool, oextra_pool, monst_pool, mextra_pool;
+
 /* used by coloratt.c, options.c, utf8map.c, windows.c */
 extern const char hexdd[33];
 
@@ -174,6 +177,10 @@ struct instance_globals_a {
         a chain of objects, use alternate phrasing after the first message */
     struct h2o_ctx acid_ctx;
 
+    /* windows.c */
+    long anim_frameno;       /* count of animation frames sent to interface */
+    unsigned long anim_due;  /* when the most recent one is to be shown */
+
     boolean havestate;
     unsigned long magic; /* validate that structure layout is preserved */
 };
@@ -395,6 +402,9 @@ struct instance_globals_f {
     /* shk.c */
     long int followmsg; /* last time of follow message */
 
+    /* teleport.c */
+    struct freecells freecells; /* unoccupied spots, for random placement */
+
     boolean havestate;
     unsigned long magic; /* validate that structure layout is preserved */
 };
@@ -433,7 +443,10 @@ struct instance_globals_g {
     genericptr_t *gmst_ubak, *gmst_disco, *gmst_mvitals;
 
     /* pline.c */
-    struct gamelog_line *gamelog;
+    struct gamelog_line *gamelog; /* gamelog_cnt entries, oldest first */
+    char *gamelog_text;           /* their texts, one after another */
+    unsigned gamelog_cnt, gamelog_max; /* entries used, allocated */
+    unsigned gamelog_textlen, gamelog_textmax; /* text used, allocated */
 
     /* region.c */
     boolean gas_cloud_diss_within;
@@ -488,12 +501,17 @@ struct instance_globals_i {
     unsigned invbufsiz;
     int in_sync_perminvent;
 
+    /* mkobj.c */
+    struct id_index oid_index; /* o_id -> obj, while id_index_begin() */
+    struct id_index mid_index; /* m_id -> monst, likewise */
+    int id_index_depth;        /* nested id_index_begin() calls */
+
     /* mon.c */
     struct monst **itermonarr; /* temporary array of all N monsters
                                 * on the current level */
 
     /* restore.c */
-    struct bucket *id_map;
+    struct id_index id_map; /* bones level ghost id -> new id */
 
     /* sp_lev.c */
     boolean in_mk_themerooms;
@@ -545,6 +563,9 @@ struct instance_globals_l {
     /* files.c */
     int lockptr;
     char lock[LOCKNAMESIZE];
+    char *livelog_queue;   /* livelog records waiting to be written */
+    size_t livelog_qlen, livelog_qmax;
+    time_t livelog_qtime;  /* when the oldest queued record was added */
 
     /* invent.c */
     int lastinvnr;  /* 0 ... 51 (never saved&restored) */
@@ -693,7 +714,6 @@ struct instance_globals_n {
     long noisetime;
 
     /* mkmap.c */
-    char *new_locations;
     int n_loc_filled;
 
     /* options.c */
@@ -708,9 +728,6 @@ struct instance_globals_n {
     /* region.c */
     int n_regions;
 
-    /* restore.c */
-    int n_ids_mapped;
-
     /* sp_lev.c */
     int num_lregions;
 
@@ -930,7 +947,7 @@ struct instance_globals_s {
     /* pline.c */
 #ifdef DUMPLOG_CORE
     unsigned saved_pline_index;  /* slot in saved_plines[] to use next */
-    char *saved_plines[DUMPLOG_MSG_COUNT];
+    char saved_plines[DUMPLOG_MSG_COUNT][BUFSZ]; /* "" if unused */
 #endif
 
     /* polyself.c */
@@ -16,6 +16,12 @@
 #endif
 
 #ifdef DLBLIB
+/* map library files into memory instead of reading them through stdio;
+   the mapping is shared by every game running on the system */
+#if defined(UNIX) && !defined(NO_DLB_MMAP)
+#define DLB_MMAP
+#endif
+
 /* directory structure in memory */
 typedef struct dlb_directory {
     char *fname;   /* file name as seen from calling code */
@@ -33,6 +39,12 @@ typedef struct dlb_library {
     long nentries; /* # of files in directory */
     long rev;      /* dlb file revision */
     long strsize;  /* dlb file string size */
+    int *hash;     /* dir[] indices by hash of name; -1 for empty slot */
+    long hashmask; /* hash table size - 1 */
+#ifdef DLB_MMAP
+    const char *map; /* whole library file; Null if not mapped */
+    long mapsize;
+#endif
 } library;
 
 /* library definitions */
@@ -60,6 +72,7 @@ typedef struct dlb_handle {
     long start;   /* offset of start of file */
     long size;    /* size of file */
     long mark;    /* current file marker */
+    const char *data; /* file contents, if library is mapped into memory */
 #endif
 #ifdef DLBRSRC
     int fd; /* HandleFile file descriptor */
@@ -85,6 +98,7 @@ int dlb_fseek(DLB_P, long, int);
 char *dlb_fgets(char *, int, DLB_P);
 int dlb_fgetc(DLB_P);
 long dlb_ftell(DLB_P);
+const char *dlb_fmap(DLB_P, long *);
 
 /* Resource DLB entry points */
 #ifdef DLBRSRC
@@ -113,6 +127,7 @@ long rsrc_dlb_ftell(dlb *dp);
 #define dlb_fgets fgets
 #define dlb_fgetc fgetc
 #define dlb_ftell ftell
+#define dlb_fmap(fp, sizep) ((const char *) 0)
 
 #endif /* DLB */
 
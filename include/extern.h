@@ -100,6 +100,14 @@ extern void welcome(boolean);
 extern int argcheck(int, char **, enum earlyarg);
 extern long timet_to_seconds(time_t);
 extern long timet_delta(time_t, time_t);
+#ifdef HOTPATH_PROFILING
+extern void prof_start(enum prof_phase);
+extern void prof_stop(enum prof_phase);
+extern void prof_turn_done(void);
+extern void prof_show(winid);
+extern void prof_reset(void);
+extern void prof_dump(void);
+#endif
 
 /* ### apply.c ### */
 
@@ -135,6 +143,9 @@ extern int unfixable_trouble_count(boolean);
 extern void init_artifacts(void);
 extern void save_artifacts(NHFILE *);
 extern void restore_artifacts(NHFILE *);
+#ifdef PREGEN_LEVELS
+extern uint64 artifact_hash(uint64);
+#endif
 extern const char *artiname(int);
 extern struct obj *mk_artifact(struct obj *, aligntyp);
 extern const char *artifact_name(const char *, short *, boolean) NONNULLARG1;
@@ -242,6 +253,7 @@ extern void sanitize_name(char *) NONNULLARG1;
 extern void drop_upon_death(struct monst *, struct obj *, coordxy, coordxy);
 extern boolean can_make_bones(void);
 extern void savebones(int, time_t, struct obj *);
+extern boolean bones_possible(void);
 extern int getbones(void);
 extern boolean bones_include_name(const char *) NONNULLARG1;
 extern void fix_ghostly_obj(struct obj *) NONNULLARG1;
@@ -314,6 +326,7 @@ extern const char *clr2colorname(int);
 extern int match_str2clr(char *, boolean) NONNULLARG1;
 extern int match_str2attr(const char *, boolean) NONNULLARG1;
 extern boolean add_menu_coloring(char *) NONNULLARG1;
+extern struct menucoloring *menu_coloring_match(const char *) NONNULLARG1;
 extern void free_one_menu_coloring(int);
 extern void free_menu_coloring(void);
 extern int count_menucolors(void);
@@ -574,11 +587,14 @@ extern int glyph_at(coordxy, coordxy);
 extern void reglyph_darkroom(void);
 extern void xy_set_wall_state(coordxy, coordxy);
 extern void set_wall_state(void);
+extern void set_wall_state_area(coordxy, coordxy, coordxy, coordxy);
 extern void unset_seenv(struct rm *, coordxy, coordxy, coordxy, coordxy);
 extern int warning_of(struct monst *) NONNULLARG1;
 extern void map_glyphinfo(coordxy, coordxy, int, unsigned, glyph_info *) NONNULLPTRS;
 extern void reset_glyphmap(enum glyphmap_change_triggers trigger);
 extern int fn_cmap_to_glyph(int);
+extern int map_snapshot(struct map_cell *, coordxy, coordxy,
+                        coordxy, coordxy) NONNULLARG1;
 
 /* ### do.c ### */
 
@@ -597,6 +613,7 @@ extern void obj_no_longer_held(struct obj *);
 extern int doddrop(void);
 extern int dodown(void);
 extern int doup(void);
+extern void record_dunlev_reached(void);
 #ifdef INSURANCE
 extern void save_currentstate(void);
 #endif
@@ -935,6 +952,7 @@ extern void wipeout_text(char *, int, unsigned) NONNULLARG1;
 extern boolean can_reach_floor(boolean);
 extern void cant_reach_floor(coordxy, coordxy, boolean, boolean);
 extern struct engr *engr_at(coordxy, coordxy);
+extern void reindex_engravings(void);
 extern struct engr *sengr_at(const char *, coordxy, coordxy, boolean) NONNULLARG1;
 extern void u_wipe_engr(int);
 extern void wipe_engr_at(coordxy, coordxy, xint16, boolean);
@@ -1000,6 +1018,13 @@ extern NHFILE *create_levelfile(int, char *);
 extern NHFILE *open_levelfile(int, char *);
 extern void delete_levelfile(int);
 extern void clearlocks(void);
+#ifdef PREGEN_LEVELS
+extern NHFILE *create_pregenfile(int);
+extern boolean commit_pregenfile(int);
+extern NHFILE *open_pregenfile(int);
+extern void delete_pregenfile(int);
+extern boolean bonesfile_exists(d_level *) NONNULLARG1;
+#endif
 extern NHFILE *create_bonesfile(d_level *, char **, char *) NONNULLARG12;
 extern void commit_bonesfile(d_level *) NONNULLARG1;
 extern NHFILE *open_bonesfile(d_level *, char **) NONNULLPTRS;
@@ -1060,6 +1085,7 @@ extern boolean read_tribute(const char *, const char *, int, char *, int,
                             unsigned);
 extern boolean Death_quote(char *, int) NONNULLARG1;
 extern void livelog_add(long ll_type, const char *) NONNULLARG2;
+extern void livelog_flush(boolean);
 
 /* ### fountain.c ### */
 
@@ -1503,6 +1529,11 @@ extern void count_level_features(void);
 extern void clear_level_structures(void);
 extern void level_finalize_topology(void);
 extern void mklev(void);
+#ifdef PREGEN_LEVELS
+extern void pregen_level_check(void);
+extern boolean pregen_load_level(xint16);
+extern void pregen_cancel(void);
+#endif
 #ifdef SPECIALIZATION
 extern void topologize(struct mkroom *, boolean) NONNULLARG1;
 #else
@@ -1575,6 +1606,12 @@ extern int rndmonnum(void);
 extern boolean bogon_is_pname(char);
 extern struct obj *splitobj(struct obj *, long) NONNULLARG1;
 extern unsigned next_ident(void);
+extern void id_index_add(struct id_index *, unsigned, anything,
+                         boolean) NONNULLARG1;
+extern anything *id_index_find(struct id_index *, unsigned) NONNULLARG1;
+extern void id_index_free(struct id_index *) NONNULLARG1;
+extern void id_index_begin(void);
+extern void id_index_end(void);
 extern struct obj *unsplitobj(struct obj *) NONNULLARG1;
 extern void clear_splitobjs(void);
 extern void replace_object(struct obj *, struct obj *) NONNULLARG12;
@@ -1629,6 +1666,8 @@ extern void obj_ice_effects(coordxy, coordxy, boolean);
 extern long peek_at_iced_corpse_age(struct obj *) NONNULLARG1;
 extern int hornoplenty(struct obj *, boolean, struct obj *);
 extern void obj_sanity_check(void);
+extern void obj_sanity_check_at(coordxy, coordxy);
+extern void obj_sanity_check_one(struct obj *) NONNULLARG1;
 extern struct obj *obj_nexto(struct obj *);
 extern struct obj *obj_nexto_xy(struct obj *, coordxy, coordxy, boolean) NONNULLARG1;
 extern struct obj *obj_absorb(struct obj **, struct obj **);
@@ -1662,6 +1701,8 @@ extern void dealloc_monst(struct monst *) NONNULLARG1;
 extern void copy_mextra(struct monst *, struct monst *);
 extern void dealloc_mextra(struct monst *) NONNULLARG1;
 extern void mon_sanity_check(void);
+extern void mon_sanity_check_at(coordxy, coordxy);
+extern void mon_sanity_check_one(struct monst *) NONNULLARG1;
 extern boolean zombie_maker(struct monst *) NONNULLARG1;
 extern int zombie_form(struct permonst *) NONNULLARG1;
 extern int m_poisongas_ok(struct monst *) NONNULLARG1;
@@ -1934,6 +1975,8 @@ extern boolean linedup_callback(coordxy, coordxy, coordxy, coordxy,
 extern boolean linedup(coordxy, coordxy, coordxy, coordxy, int);
 extern boolean lined_up(struct monst *) NONNULLARG1;
 extern struct obj *m_carrying(struct monst *, int) NONNULLARG1;
+extern struct minvsum *m_invsum(struct monst *) NONNULL NONNULLARG1;
+extern void obj_retyped(struct obj *) NONNULLARG1;
 extern int thrwmm(struct monst *, struct monst *) NONNULLARG12;
 extern int spitmm(struct monst *, struct attack *, struct monst *) NONNULLPTRS;
 extern int breamm(struct monst *, struct attack *, struct monst *) NONNULLPTRS;
@@ -2221,12 +2264,19 @@ extern void set_wc2_option_mod_status(unsigned long, int);
 extern void set_option_mod_status(const char *, int) NONNULLARG1;
 extern int add_autopickup_exception(const char *) NONNULLARG1;
 extern void free_autopickup_exceptions(void);
+extern struct autopickup_exception *autopickup_exception_match(
+                                                  const char *) NONNULLARG1;
 extern void set_playmode(void);
 extern int sym_val(const char *) NONNULLARG1;
 extern boolean msgtype_parse_add(char *) NONNULLARG1;
 extern int msgtype_type(const char *, boolean) NONNULLARG1;
 extern void hide_unhide_msgtypes(boolean, int);
 extern void msgtype_free(void);
+extern void regex_cache_clear(struct regex_cache *) NONNULLARG1;
+extern boolean regex_cache_find(struct regex_cache *, genericptr_t,
+                                const char *, genericptr_t *) NONNULLPTRS;
+extern void regex_cache_add(struct regex_cache *, const char *,
+                            genericptr_t) NONNULLARG12;
 
 /* ### pager.c ### */
 
@@ -2361,6 +2411,8 @@ extern void You_see(const char *, ...) PRINTF_F(1, 2);
 extern void pline_The(const char *, ...) PRINTF_F(1, 2);
 extern void There(const char *, ...) PRINTF_F(1, 2);
 extern void verbalize(const char *, ...) PRINTF_F(1, 2);
+extern void gamelog_reserve(unsigned, unsigned);
+extern void gamelog_free(void);
 extern void gamelog_add(long, long, const char *);
 extern void livelog_printf(long, const char *, ...) PRINTF_F(2, 3);
 extern void raw_printf(const char *, ...) PRINTF_F(1, 2);
@@ -2615,6 +2667,9 @@ extern void genl_outrip(winid, int, time_t);
 #ifdef USE_ISAAC64
 extern void init_isaac64(unsigned long, int(*fn)(int));
 extern long nhrand(void);
+extern size_t core_rng_state_size(void);
+extern void get_core_rng_state(genericptr_t) NONNULLARG1;
+extern void set_core_rng_state(const genericptr_t) NONNULLARG1;
 #endif
 extern int rn2(int);
 extern int rn2_on_display_rng(int);
@@ -2960,6 +3015,7 @@ extern void stairway_add(coordxy, coordxy,
                          boolean, boolean, d_level *) NONNULLPTRS;
 extern void stairway_free_all(void);
 extern stairway *stairway_at(coordxy, coordxy);
+extern void reindex_stairs(void);
 extern stairway *stairway_find(d_level *) NONNULLARG1;
 extern stairway *stairway_find_from(d_level *, boolean) NONNULLARG1;
 extern stairway *stairway_find_dir(boolean);
@@ -3053,6 +3109,13 @@ extern boolean enexto(coord *, coordxy, coordxy,
                       struct permonst *) NONNULLARG1;
 extern boolean enexto_core(coord *, coordxy, coordxy, struct permonst *,
                            mmflags_nht) NONNULLARG1;
+extern void freecell_update(coordxy, coordxy);
+extern void freecell_newterrain(coordxy, coordxy);
+extern void freecell_reset(void);
+extern int freecell_kinds(struct monst *, mmflags_nht) NO_NNARGS;
+extern boolean freecell_random(int, coord *) NONNULLARG2;
+extern int freecell_count(int, boolean);
+extern void freecell_nth(int, coord *) NONNULLARG2;
 extern void teleds(coordxy, coordxy, int);
 extern int collect_coords(coord *, coordxy, coordxy, int, unsigned,
                           boolean (*)(coordxy, coordxy)) NONNULLARG1;
@@ -3188,6 +3251,7 @@ extern boolean chest_trap(struct obj *, int, boolean) NONNULLARG1;
 extern void deltrap(struct trap *) NONNULLARG1;
 extern boolean delfloortrap(struct trap *) NO_NNARGS;
 extern struct trap *t_at(coordxy, coordxy);
+extern void reindex_traps(void);
 extern int count_traps(int);
 extern void b_trapped(const char *, int) NONNULLARG1;
 extern boolean unconscious(void);
@@ -3666,6 +3730,7 @@ extern void add_menu_heading(winid, const char *) NONNULLARG2;
 extern void add_menu_str(winid, const char *) NONNULLARG2;
 extern int select_menu(winid, int, menu_item **) NONNULLARG3;
 extern void getlin(const char *, char *) NONNULLARG2;
+extern void nh_delay_output(void);
 
 /* ### windsys.c ### */
 
@@ -3709,6 +3774,7 @@ extern int wiz_map(void);
 extern int wiz_migrate_mons(void);
 extern int wiz_panic(void);
 extern int wiz_polyself(void);
+extern int wiz_profile(void);
 extern int wiz_rumor_check(void);
 extern int wiz_show_seenv(void);
 extern int wiz_show_stats(void);
@@ -3721,7 +3787,17 @@ extern int wiz_wish(void);
 extern void makemap_remove_mons(void);
 extern void wiz_levltyp_legend(void);
 extern void wiz_map_levltyp(void);
-extern void wizcustom_callback(winid win, int glyphnum, char *id);
+extern void wizcustom_callback(winid win, int glyphnum, const char *id);
+extern void sanity_touch_obj(struct obj *) NONNULLARG1;
+extern void sanity_touch_mon(struct monst *) NONNULLARG1;
+extern void sanity_forget_obj(struct obj *) NONNULLARG1;
+extern void sanity_forget_mon(struct monst *) NONNULLARG1;
+#ifdef FUZZ_SNAPSHOTS
+extern void fuzz_snapshot_check(void);
+extern const char *fuzz_parent_levelfile(int);
+ATTRNORETURN extern void fuzz_worker_done(int) NORETURN;
+ATTRNORETURN extern void fuzz_crash(const char *, const char *) NORETURN;
+#endif
 #if (NH_DEVEL_STATUS != NH_STATUS_RELEASED) || defined(DEBUG)
 extern int wiz_display_macros(void);
 extern int wiz_mon_diff(void);
@@ -291,6 +291,15 @@ typedef uchar nhsym;
     && (defined(NOSAVEONHANGUP) || !defined(HANGUPHANDLING))
 #undef SAFERHANGUP
 #endif
+/* level pre-generation hands the RNG state from one process to another */
+#if defined(PREGEN_LEVELS) \
+    && (!defined(USE_ISAAC64) || !defined(HANGUPHANDLING))
+#undef PREGEN_LEVELS
+#endif
+/* fuzz workers run with the hangup window procs */
+#if defined(FUZZ_SNAPSHOTS) && !defined(HANGUPHANDLING)
+#undef FUZZ_SNAPSHOTS
+#endif
 
 #define Sprintf (void) sprintf
 #define Strcat (void) strcat
@@ -353,6 +362,39 @@ extern long *alloc(unsigned int) NONNULL;  /* alloc.c */
 extern long *re_alloc(long *, unsigned int) NONNULL;
 #endif /* ?MONITOR_HEAP */
 
+/*
+ * Fixed-size allocation pools for structures which get created and
+ * released in bulk (objects, monsters, and their extensions).  Items
+ * are carved out of slabs of 'perslab' items and recycled through a
+ * free list; slabs which become entirely unused are handed back by
+ * nhpool_trim(), which is called after the old level is released
+ * during level change.  Pool items are released with nhpool_put(),
+ * never with free(); nhpool_free_all() releases all the slabs at exit.
+ *
+ * See alloc.c.
+ */
+struct nhpool_slab;
+struct nhpool {
+    const char *name;          /* for #stats */
+    unsigned itemsize;         /* sizeof the pooled struct */
+    unsigned perslab;          /* number of items per slab */
+    struct nhpool_slab *slabs; /* all slabs belonging to this pool */
+    genericptr_t freelist;     /* available items, threaded through them */
+    struct nhpool *nextpool;   /* list of pools which have been used */
+    long nslabs, inuse, nfree; /* current counts */
+    long peak, gets, released; /* high-water mark, lifetime counts */
+};
+#define NHPOOL_INIT(nam, typ, cnt) \
+    { nam, (unsigned) sizeof (typ), cnt, 0, 0, 0, 0L, 0L, 0L, 0L, 0L, 0L }
+
+extern genericptr_t nhpool_get(struct nhpool *) NONNULL NONNULLARG1;
+extern void nhpool_put(struct nhpool *, genericptr_t) NONNULLARG12;
+extern void nhpool_trim(struct nhpool *) NONNULLARG1;
+extern void nhpool_trim_all(void);
+extern void nhpool_free_all(void);
+extern struct nhpool *nhpool_list(void);
+extern long nhpool_bytes(struct nhpool *) NONNULLARG1;
+
 /* Used for consistency checks of various data files; declare it here so
    that utility programs which include config.h but not hack.h can see it. */
 struct version_info {
@@ -477,9 +477,9 @@ enum game_end_types {
 struct gamelog_line {
     long turn; /* turn when this happened */
     long flags; /* LL_foo flags */
-    char *text;
-    struct gamelog_line *next;
+    unsigned text; /* offset of its text in gg.gamelog_text[] */
 };
+#define gamelog_msg(llmsg) (&gg.gamelog_text[(llmsg)->text])
 
 
 /* values returned from getobj() callback functions */
@@ -535,6 +535,14 @@ enum hmon_atkmode_types {
     HMON_DRAGGED = 4  /* attached iron ball, pulled into mon */
 };
 
+/* hash table from an o_id or m_id to something; see id_index_add() */
+struct id_index {
+    unsigned *ids;  /* 0 marks an unused slot */
+    anything *vals;
+    unsigned size;  /* number of slots, a power of 2; 0 until first use */
+    unsigned count; /* number of slots in use */
+};
+
 /* hunger states - see hu_stat in eat.c */
 enum hunger_state_types {
     SATIATED   = 0,
@@ -590,6 +598,21 @@ struct menucoloring {
     struct menucoloring *next;
 };
 
+/* recent strings checked against a list of regex rules (MSGTYPE,
+   MENUCOLOR and so on) along with the first rule each one matched, so
+   that a repeated message or menu line doesn't go through every rule
+   again; see regex_cache_find() in options.c */
+#define REGEX_CACHE_SIZE 16
+struct regex_cache {
+    genericptr_t list; /* first rule of the list the entries are for */
+    int next;          /* entry to replace next */
+    struct regex_cache_ent {
+        boolean used;
+        genericptr_t rule; /* Null: no rule matched */
+        char str[BUFSZ];
+    } ent[REGEX_CACHE_SIZE];
+};
+
 enum movemodes {
     MV_ANY = -1,
     MV_WALK,
@@ -770,6 +793,12 @@ struct sinfo {
     int in_impossible;          /* reporting a warning */
     int in_docrt;               /* in docrt(): redrawing the whole screen */
     int in_self_recover;        /* processing orphaned level files */
+#ifdef PREGEN_LEVELS
+    int pregen_helper;          /* forked to make a level ahead of time */
+#endif
+#ifdef FUZZ_SNAPSHOTS
+    int fuzz_worker;            /* forked to fuzz from a snapshot */
+#endif
     int in_checkpoint;          /* saving insurance checkpoint */
     int in_parseoptions;        /* in parseoptions */
     int in_role_selection;      /* role/race/&c selection menus in progress */
@@ -1473,6 +1502,31 @@ typedef uint32_t mmflags_nht;     /* makemon MM_ flags */
 #define DEVTEAM_EMAIL "devteam@nethack.org"
 #define DEVTEAM_URL "https://www.nethack.org/"
 
+/* phases timed by the HOTPATH_PROFILING instrumentation; see allmain.c */
+enum prof_phase {
+    PROF_TURN = 0,   /* everything done between hero's moves */
+    PROF_MOVEMON,    /* movemon() */
+    PROF_TIMEOUT,    /* nh_timeout(), including run_timers() */
+    PROF_TIMERS,     /* run_timers() */
+    PROF_REGIONS,    /* run_regions() */
+    PROF_VISION,     /* vision_recalc() */
+    PROF_BOT,        /* bot() */
+    PROF_FLUSH,      /* flush_screen() */
+    PROF_MKLEV,      /* mklev(), including bones */
+    PROF_SAVELEV,    /* savelev() */
+    PROF_GETLEV,     /* getlev() */
+    PROF_SAVEGAME,   /* savegamestate() */
+    PROF_RESTGAME,   /* restgamestate() */
+    NUM_PROF_PHASES
+};
+#ifdef HOTPATH_PROFILING
+#define PROF_START(phase) prof_start(phase)
+#define PROF_STOP(phase) prof_stop(phase)
+#else
+#define PROF_START(phase) do { } while (0)
+#define PROF_STOP(phase) do { } while (0)
+#endif
+
 #if !defined(CROSSCOMPILE) || defined(CROSSCOMPILE_TARGET)
 #include "nhlua.h"
 #endif
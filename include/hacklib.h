@@ -62,6 +62,8 @@ extern int case_insensitive_comp(const char *, const char *);
 extern boolean fuzzymatch(const char *, const char *,
                           const char *, boolean) NONNULLPTRS;
 extern int swapbits(int, int, int);
+extern uint64 hash_bytes(uint64, const genericptr_t, size_t);
+extern boolean regex_literal(const char *, char *, size_t) NONNULLPTRS;
 /* note: the snprintf CPP wrapper includes the "fmt" argument in "..."
    (__VA_ARGS__) to allow for zero arguments after fmt */
 extern void nh_snprintf(const char *func, int line, char *str,
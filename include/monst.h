@@ -85,6 +85,25 @@ enum m_seen_resistance {
     M_SEEN_REFL    = 0x0100, /* reflection, no corresponding AD_foo */
 };
 
+/* what a monster (or the hero, via gy.youmonst) is carrying, summarized
+   so that code looking for some particular item can usually skip walking
+   the inventory; it may claim things which are no longer there but never
+   omits anything which is, and is rebuilt on demand after the inventory
+   changes (see m_invsum(), mthrowu.c) */
+struct minvsum {
+    uint64 otyps;    /* bit (otyp % 64) set for each type carried */
+    uint32 classes;  /* bit oclass set for each class carried */
+    boolean valid;   /* FALSE: needs to be rebuilt before use */
+};
+
+#define minvsum_bit(otyp) ((uint64) 1 << ((otyp) % 64))
+/* FALSE: mon definitely isn't carrying anything of type otyp */
+#define m_might_carry(mon, otyp) \
+    ((m_invsum(mon)->otyps & minvsum_bit(otyp)) != 0)
+#define m_might_carry_class(mon, oclass) \
+    ((m_invsum(mon)->classes & (1U << (oclass))) != 0)
+#define minvent_changed(mon) ((mon)->minvsum.valid = FALSE)
+
 #define m_seenres(mon, mask) ((mon)->seen_resistance & (mask))
 #define m_setseenres(mon, mask) ((mon)->seen_resistance |= (mask))
 #define m_clearseenres(mon, mask) ((mon)->seen_resistance &= ~(mask))
@@ -194,13 +213,14 @@ struct monst {
     struct obj *minvent;   /* mon's inventory */
     struct obj *mw;        /* mon's weapon */
     long misc_worn_check;  /* mon's wornmask */
+    struct minvsum minvsum; /* summary of minvent, or of invent for hero */
     xint16 weapon_check;   /* flag for whether to try switching weapons */
 
     int meating;           /* monster is eating timeout */
     struct mextra *mextra; /* point to mextra struct */
 };
 
-#define newmonst() (struct monst *) alloc(sizeof (struct monst))
+#define newmonst() (struct monst *) nhpool_get(&monst_pool)
 
 /* these are in mspeed */
 #define MSLOW 1 /* slowed monster */
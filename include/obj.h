@@ -173,7 +173,7 @@ struct obj {
     struct oextra *oextra; /* pointer to oextra struct */
 };
 
-#define newobj() (struct obj *) alloc(sizeof (struct obj))
+#define newobj() (struct obj *) nhpool_get(&obj_pool)
 
 /***
  **     oextra referencing and testing macros
@@ -581,6 +581,15 @@ static int optfn_##a(int, int, boolean, char *, char *);
     NHOPTB(popup_dialog, Advanced, 0, opt_in, set_in_game,
            Off, Yes, No, No, NoAlias, &iflags.wc_popup_dialog, Term_False,
            (char *)0)
+#ifdef PREGEN_LEVELS
+    NHOPTB(pregen_levels, Advanced, 0, opt_in, set_in_game,
+           Off, Yes, No, No, NoAlias, &iflags.pregen_levels, Term_False,
+           "make the level below ahead of time when on stairs")
+#else
+    NHOPTB(pregen_levels, Advanced, 0, opt_in, set_in_config,
+           Off, No, No, No, NoAlias, (boolean *) 0, Term_False,
+           (char *)0)
+#endif
     NHOPTB(preload_tiles, Advanced, 0, opt_out, set_in_config, /* MSDOS only */
            On, Yes, No, No, NoAlias, &iflags.wc_preload_tiles, Term_False,
            (char *)0)
@@ -622,6 +631,12 @@ static int optfn_##a(int, int, boolean, char *, char *);
     NHOPTB(sanity_check, Advanced, 0, opt_in, set_wizonly,
            Off, Yes, No, No, NoAlias, &iflags.sanity_check, Term_False,
            "perform data sanity checks")
+    NHOPTC(sanity_check_budget, Advanced, 10, opt_in, set_wizonly,
+                Yes, Yes, No, No, NoAlias,
+                "sanity_check: objects, monsters, and spots checked per turn")
+    NHOPTC(sanity_check_interval, Advanced, 10, opt_in, set_wizonly,
+                Yes, Yes, No, No, NoAlias,
+                "sanity_check: turns between full checks when budgeted")
     NHOPTC(scores, Advanced, 32, opt_in, set_in_game,
                 No, Yes, No, No, NoAlias,
                 "the parts of the score list you wish to see")
@@ -260,6 +260,24 @@ struct rm {
     Bitfield(candig, 1); /* Exception to Can_dig_down; was a trapdoor */
 };
 
+/* a map location as copied out in bulk by map_snapshot(), for Lua
+   (nh.getmapcells()) and for programs embedding the game (libnh) */
+struct map_cell {
+    int glyph;   /* levl[][].glyph */
+    schar typ;   /* levl[][].typ */
+    uchar seenv; /* levl[][].seenv */
+    uchar flags; /* levl[][].flags */
+    uchar ttyp;  /* type of trap there, or NO_TRAP */
+    uchar bits;  /* MAPCELL_xxx */
+};
+
+#define MAPCELL_LIT        0x01 /* levl[][].lit */
+#define MAPCELL_WASLIT     0x02 /* levl[][].waslit */
+#define MAPCELL_HORIZONTAL 0x04 /* levl[][].horizontal */
+#define MAPCELL_MONSTER    0x08 /* a monster is there, seen or not */
+#define MAPCELL_OBJECT     0x10 /* one or more objects are there */
+#define MAPCELL_HERO       0x20 /* hero is there */
+
 /* light states for terrain replacements, for set_levltyp_lit */
 #define SET_LIT_RANDOM -1
 #define SET_LIT_NOCHANGE -2
@@ -324,6 +342,20 @@ struct rm {
 #define WM_X_TLBR 5
 #define WM_X_BLTR 6
 
+/*
+ * Neighbour masks, used when working out wall spines and wall modes:
+ * one bit for each location adjacent to <x,y>, clockwise from the top
+ * left like the seen vector below.
+ */
+#define WN_TL 0x01 /* <x-1,y-1> */
+#define WN_T  0x02 /* <x,  y-1> */
+#define WN_TR 0x04 /* <x+1,y-1> */
+#define WN_R  0x08 /* <x+1,y  > */
+#define WN_BR 0x10 /* <x+1,y+1> */
+#define WN_B  0x20 /* <x,  y+1> */
+#define WN_BL 0x40 /* <x-1,y+1> */
+#define WN_L  0x80 /* <x-1,y  > */
+
 /*
  * Seen vector values.  The seen vector is an array of 8 bits, one for each
  * octant around a given center x:
@@ -430,6 +462,11 @@ typedef struct {
     struct rm locations[COLNO][ROWNO];
     struct obj *objects[COLNO][ROWNO];
     struct monst *monsters[COLNO][ROWNO];
+    /* per-location indices into the trap, engraving, and stairway lists
+       so that t_at(), engr_at(), and stairway_at() needn't search them */
+    struct trap *traps[COLNO][ROWNO];
+    struct engr *engravings[COLNO][ROWNO];
+    struct stairway *stairways[COLNO][ROWNO];
     struct obj *objlist;
     struct obj *buriedobjlist;
     struct monst *monlist;
@@ -478,18 +515,46 @@ typedef struct {
         if (gl.level.monsters[x][y] && gl.level.monsters[x][y] != m) \
             impossible("place_worm_seg over mon");                   \
         gl.level.monsters[x][y] = m;                                 \
+        freecell_update(x, y);                                       \
     } while(0)
 #define remove_monster(x, y) \
     do {                                                  \
         if (!gl.level.monsters[x][y])                     \
             impossible("no monster to remove");           \
         gl.level.monsters[x][y] = (struct monst *) 0;     \
+        freecell_update(x, y);                            \
     } while(0)
 #else
-#define place_worm_seg(m, x, y) gl.level.monsters[x][y] = m
-#define remove_monster(x, y) gl.level.monsters[x][y] = (struct monst *) 0
+#define place_worm_seg(m, x, y) \
+    (gl.level.monsters[x][y] = m, freecell_update(x, y))
+#define remove_monster(x, y) \
+    (gl.level.monsters[x][y] = (struct monst *) 0, freecell_update(x, y))
 #endif
 
+/*
+ * Unoccupied map locations grouped by terrain so that random placement
+ * can pick among the spots a monster might be able to use instead of
+ * probing the whole map; see teleport.c.
+ */
+enum freecell_kinds {
+    FC_WALK = 0, /* ACCESSIBLE() terrain other than water and lava */
+    FC_WATER,    /* pools, moat, water, lava */
+    FC_SOLID,    /* stone, walls, trees, iron bars, ... */
+    FC_TAKEN,    /* has a monster on it, or is column 0 */
+    NUM_FC_KINDS
+};
+
+struct freecells {
+    short cell[COLNO * ROWNO];     /* x * ROWNO + y, grouped by kind */
+    short where[COLNO][ROWNO];     /* index of <x,y> in cell[] */
+    short start[NUM_FC_KINDS + 1]; /* first slot in cell[] of each kind */
+    schar terrain[COLNO][ROWNO];   /* FC_WALK, FC_WATER, or FC_SOLID */
+    long stamp;                    /* gm.moves when last rebuilt */
+    xint16 ledger;                 /* ledger_no() of the level described */
+    int filterkind;                /* for collect_coords() filtering */
+    boolean valid;
+};
+
 /* restricted movement, potential luck penalties */
 #define Sokoban gl.level.flags.sokoban_rules
 
@@ -133,6 +133,21 @@
  */
 #define CHECK_PANIC_SAVE
 
+/*
+ * Support the 'pregen_levels' option:  while the hero stands on stairs
+ * leading to a level which hasn't been made yet, fork a helper process
+ * to make it so that taking the stairs only needs to read a file.
+ * Requires USE_ISAAC64 (config.h).
+ */
+#define PREGEN_LEVELS
+
+/*
+ * Let the fuzz tester (#debugfuzzer in wizard mode) fork many short
+ * runs from states that took a while to reach, when NH_FUZZDIR is set
+ * in the environment.  See src/wizcmds.c.
+ */
+#define FUZZ_SNAPSHOTS
+
 /* #define AVOID_WIN_IOCTL */ /* ensure USE_WIN_IOCTL remains undefined */
 
 /*
@@ -161,7 +161,11 @@ extern
 /* #define getlin (*windowprocs.win_getlin) */
 #define get_ext_cmd (*windowprocs.win_get_ext_cmd)
 #define number_pad (*windowprocs.win_number_pad)
-#define nh_delay_output (*windowprocs.win_delay_output)
+/* 3.7: There is a real nh_delay_output() in the core now, which lets
+ *      an interface that paces its own animation carry on instead of
+ *      sleeping.  nh_delay_output() is in windows.c
+ */
+/* #define nh_delay_output (*windowprocs.win_delay_output) */
 #ifdef CHANGE_COLOR
 #define change_color (*windowprocs.win_change_color)
 #ifdef MAC
@@ -267,7 +271,9 @@ extern
 #define WC2_MENU_SHIFT   0x010000L /* 17 horizontal menu scrolling */
 #define WC2_U_UTF8STR    0x020000L /* 18 utf8str support */
 #define WC2_EXTRACOLORS  0x040000L /* 19 color support beyond NH_BASIC_COLOR */
-                                   /* 13 free bits */
+#define WC2_ANIMFRAMES   0x080000L /* 20 ctrl_nhwindow(anim_frame) instead of
+                                    *    delay_output(); port paces frames */
+                                   /* 12 free bits */
 
 #define ALIGN_LEFT   1
 #define ALIGN_RIGHT  2
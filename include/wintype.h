@@ -212,6 +212,7 @@ enum from_core_requests {
     set_mode             = 1,
     request_settings     = 2,
     set_menu_promptstyle = 3,
+    anim_frame           = 4,
 };
 
 struct to_core {
@@ -227,6 +228,13 @@ struct from_core {
     enum from_core_requests core_request;
     enum inv_modes invmode;
     color_attr menu_promptstyle;
+    /* anim_frame: everything output since the previous frame boundary
+       belongs to frame number frame_num, which should be shown at time
+       frame_ms (milliseconds, arbitrary origin) and left on display for
+       frame_delay milliseconds before whatever follows it */
+    long frame_num;
+    unsigned long frame_ms;
+    int frame_delay;
 };
 
 struct win_request_info_t {
@@ -180,6 +180,7 @@ moveloop_core(void)
     if (iflags.sanity_check || iflags.debug_fuzzer)
         sanity_check();
 
+    PROF_START(PROF_TURN);
     if (gc.context.move) {
         /* actual time passed */
         u.umovement -= NORMAL_SPEED;
@@ -189,7 +190,9 @@ moveloop_core(void)
 
             gc.context.mon_moving = TRUE;
             do {
+                PROF_START(PROF_MOVEMON);
                 monscanmove = movemon();
+                PROF_STOP(PROF_MOVEMON);
                 if (u.umovement >= NORMAL_SPEED)
                     break; /* it's now your turn */
             } while (monscanmove);
@@ -237,6 +240,9 @@ moveloop_core(void)
                 /* 'moves' is misnamed; it represents turns; hero_seq is
                    a value that is distinct every time the hero moves */
                 gh.hero_seq = gm.moves << 3;
+#ifdef HOTPATH_PROFILING
+                prof_turn_done();
+#endif
 
                 if (flags.time && !gc.context.run)
                     disp.time_botl = TRUE; /* 'moves' just changed */
@@ -246,11 +252,16 @@ moveloop_core(void)
                 /********************************/
 
                 l_nhcore_call(NHCORE_MOVELOOP_TURN);
+                livelog_flush(FALSE); /* if enough has piled up */
 
                 if (Glib)
                     glibr();
+                PROF_START(PROF_TIMEOUT);
                 nh_timeout();
+                PROF_STOP(PROF_TIMEOUT);
+                PROF_START(PROF_REGIONS);
                 run_regions();
+                PROF_STOP(PROF_REGIONS);
 
                 if (u.ublesscnt)
                     u.ublesscnt--;
@@ -408,6 +419,7 @@ moveloop_core(void)
             under_ground(0);
 
     } /* actual time passed */
+    PROF_STOP(PROF_TURN);
 
     /****************************************/
     /* once-per-player-input things go here */
@@ -496,6 +508,13 @@ moveloop_core(void)
     } else if (gm.multi == 0) {
 #ifdef MAIL
         ckmailstatus();
+#endif
+#ifdef PREGEN_LEVELS
+        pregen_level_check();
+#endif
+#ifdef FUZZ_SNAPSHOTS
+        if (iflags.debug_fuzzer)
+            fuzz_snapshot_check();
 #endif
         rhack(0);
     }
@@ -1109,6 +1128,207 @@ timet_delta(time_t etim, time_t stim) /* end and start times */
     return (long) difftime(etim, stim);
 }
 
+#ifdef HOTPATH_PROFILING
+/*
+ * Hot-path profiling.
+ *
+ * PROF_START() and PROF_STOP() bracket the phases listed in enum
+ * prof_phase (hack.h).  Each phase accumulates a call count, total and
+ * maximum elapsed time, and its share of the current turn; when a turn
+ * ends, the turn with the largest total so far has its per-phase
+ * breakdown remembered so that a slow turn can be attributed to a
+ * subsystem.  Phases may be nested inside other phases (getlev() for
+ * bones happens within mklev()); re-entering the same phase only counts
+ * the outermost use.
+ */
+
+static const char *const prof_names[NUM_PROF_PHASES] = {
+    "turn", "movemon", "timeout", "timers", "regions", "vision",
+    "bot", "flush", "mklev", "savelev", "getlev", "savegame", "restgame",
+};
+
+static struct prof_stat {
+    long calls;
+    int depth;
+    uint64 start, total, max, thisturn;
+} prof_stats[NUM_PROF_PHASES];
+
+static struct prof_worst {
+    long moves;
+    uint64 total, phase[NUM_PROF_PHASES];
+} prof_worst;
+
+static long prof_turns = 0L, prof_lastdump = 0L;
+
+staticfn uint64 prof_now(void);
+staticfn void prof_json_phases(FILE *, uint64 *);
+
+/* monotonic time in microseconds */
+staticfn uint64
+prof_now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64) ts.tv_sec * 1000000ULL + (uint64) ts.tv_nsec / 1000ULL;
+#else
+    /* processor time rather than wall clock, but better than nothing */
+    return (uint64) clock() * 1000000ULL / (uint64) CLOCKS_PER_SEC;
+#endif
+}
+
+void
+prof_start(enum prof_phase phase)
+{
+    struct prof_stat *ps = &prof_stats[phase];
+
+    if (ps->depth++ == 0)
+        ps->start = prof_now();
+}
+
+void
+prof_stop(enum prof_phase phase)
+{
+    struct prof_stat *ps = &prof_stats[phase];
+    uint64 elapsed;
+
+    if (ps->depth <= 0 || --ps->depth > 0)
+        return;
+    elapsed = prof_now() - ps->start;
+    ps->calls++;
+    ps->total += elapsed;
+    ps->thisturn += elapsed;
+    if (elapsed > ps->max)
+        ps->max = elapsed;
+}
+
+/* called once per turn; remembers the slowest turn's breakdown and
+   writes to NH_PROFILELOG every NH_PROFILEINTERVAL turns */
+void
+prof_turn_done(void)
+{
+    static long interval = -1L;
+    uint64 now = prof_now();
+    int i;
+
+    /* phases still running (PROF_TURN itself, since the turn counter is
+       advanced from within it) have the part so far charged to the turn
+       that is ending */
+    for (i = 0; i < NUM_PROF_PHASES; ++i)
+        if (prof_stats[i].depth > 0) {
+            prof_stats[i].total += now - prof_stats[i].start;
+            prof_stats[i].thisturn += now - prof_stats[i].start;
+            prof_stats[i].start = now;
+        }
+    ++prof_turns;
+    if (prof_stats[PROF_TURN].thisturn > prof_worst.total) {
+        prof_worst.moves = gm.moves;
+        prof_worst.total = prof_stats[PROF_TURN].thisturn;
+        for (i = 0; i < NUM_PROF_PHASES; ++i)
+            prof_worst.phase[i] = prof_stats[i].thisturn;
+    }
+    for (i = 0; i < NUM_PROF_PHASES; ++i)
+        prof_stats[i].thisturn = 0;
+
+    if (interval < 0L) {
+        const char *p = nh_getenv("NH_PROFILEINTERVAL");
+
+        interval = (p && *p) ? atol(p) : 1000L;
+        if (interval < 1L)
+            interval = 1000L;
+    }
+    if (gm.moves - prof_lastdump >= interval)
+        prof_dump();
+}
+
+void
+prof_reset(void)
+{
+    (void) memset((genericptr_t) prof_stats, 0, sizeof prof_stats);
+    (void) memset((genericptr_t) &prof_worst, 0, sizeof prof_worst);
+    prof_turns = 0L;
+    prof_lastdump = gm.moves;
+}
+
+staticfn void
+prof_json_phases(FILE *fp, uint64 *phasetimes)
+{
+    int i;
+
+    for (i = 0; i < NUM_PROF_PHASES; ++i) {
+        if (phasetimes) {
+            if (phasetimes[i])
+                fprintf(fp, "%s\"%s\":%llu", i ? "," : "", prof_names[i],
+                        (unsigned long long) phasetimes[i]);
+        } else {
+            fprintf(fp,
+                    "%s\"%s\":{\"calls\":%ld,\"usec\":%llu,\"max\":%llu}",
+                    i ? "," : "", prof_names[i], prof_stats[i].calls,
+                    (unsigned long long) prof_stats[i].total,
+                    (unsigned long long) prof_stats[i].max);
+        }
+    }
+}
+
+/* append the figures for the interval since the last dump to the file
+   named by NH_PROFILELOG as a single line of JSON, then start over */
+void
+prof_dump(void)
+{
+    const char *fname = nh_getenv("NH_PROFILELOG");
+    FILE *fp;
+
+    if (fname && *fname && prof_turns > 0L
+        && (fp = fopen(fname, "a")) != 0) {
+        fprintf(fp, "{\"version\":\"%d.%d.%d\",\"pid\":%ld,"
+                    "\"moves\":%ld,\"turns\":%ld,\"depth\":%d,",
+                VERSION_MAJOR, VERSION_MINOR, PATCHLEVEL,
+                (long) gh.hackpid, gm.moves, prof_turns, depth(&u.uz));
+        fprintf(fp, "\"phases\":{");
+        prof_json_phases(fp, (uint64 *) 0);
+        fprintf(fp, "},\"worst\":{\"moves\":%ld,\"usec\":%llu,"
+                    "\"phases\":{",
+                prof_worst.moves, (unsigned long long) prof_worst.total);
+        prof_json_phases(fp, prof_worst.phase);
+        fprintf(fp, "}}}\n");
+        (void) fclose(fp);
+    }
+    prof_reset();
+}
+
+/* for #wizprofile */
+void
+prof_show(winid win)
+{
+    static const char fmt[] = "%-10s %8ld %12llu %10llu %8llu %10llu";
+    char buf[BUFSZ];
+    int i;
+
+    Sprintf(buf, "Hot-path profile for %ld turns (T:%ld..%ld), in usec:",
+            prof_turns, prof_lastdump, gm.moves);
+    putstr(win, 0, buf);
+    putstr(win, 0, "");
+    putstr(win, 0,
+           "phase         calls        total        max  average  worstturn");
+    for (i = 0; i < NUM_PROF_PHASES; ++i) {
+        struct prof_stat *ps = &prof_stats[i];
+
+        Snprintf(buf, sizeof buf, fmt, prof_names[i], ps->calls,
+                 (unsigned long long) ps->total,
+                 (unsigned long long) ps->max,
+                 (unsigned long long) (ps->calls
+                                       ? ps->total / (uint64) ps->calls : 0),
+                 (unsigned long long) prof_worst.phase[i]);
+        putstr(win, 0, buf);
+    }
+    putstr(win, 0, "");
+    Sprintf(buf, "Slowest turn was T:%ld, %llu usec.", prof_worst.moves,
+            (unsigned long long) prof_worst.total);
+    putstr(win, 0, buf);
+}
+#endif /* HOTPATH_PROFILING */
+
 #if !defined(NODUMPENUMS)
 /* monsdump[] and objdump[] are also used in utf8map.c */
 
@@ -251,6 +251,218 @@ dupstr_n(const char *string, unsigned int *lenout)
 }
 
 
+/*
+ * Fixed-size allocation pools; see global.h.
+ *
+ * Each item is preceded by a pointer to the slab which contains it so
+ * that nhpool_put() can maintain per-slab usage counts; that is what
+ * lets nhpool_trim() find and release slabs which have become empty.
+ * With MONITOR_HEAP, items are allocated individually so that heap
+ * logging continues to report each one.
+ */
+
+struct nhpool_slab {
+    struct nhpool_slab *next;
+    unsigned inuse; /* number of items handed out from this slab */
+};
+
+union nhpool_hdr {
+    struct nhpool_slab *slab;
+    long align_l;
+    double align_d;
+    genericptr_t align_p;
+};
+
+#define PoolItemSpan(P) ((unsigned) sizeof (union nhpool_hdr) + (P)->itemsize)
+#define PoolSlabItem(S, P, i) \
+    ((union nhpool_hdr *) ((char *) ((S) + 1) + (i) * PoolItemSpan(P)))
+/* free items keep a link to the next free item in their first bytes */
+#define PoolNextFree(item) (*(genericptr_t *) (item))
+
+static struct nhpool *nhpools = 0; /* every pool that's been used */
+
+staticfn void nhpool_grow(struct nhpool *);
+
+/* add another slab's worth of items to a pool's free list */
+staticfn void
+nhpool_grow(struct nhpool *pool)
+{
+    struct nhpool_slab *slab;
+    union nhpool_hdr *hdr;
+    unsigned i;
+
+    ForceAlignedLength(pool->itemsize);
+    if (pool->itemsize < sizeof (genericptr_t))
+        pool->itemsize = (unsigned) sizeof (genericptr_t);
+    if (!pool->perslab)
+        pool->perslab = 32;
+    slab = (struct nhpool_slab *) alloc((unsigned) sizeof *slab
+                                        + pool->perslab
+                                          * PoolItemSpan(pool));
+    slab->inuse = 0;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->nslabs++;
+    /* thread the new items onto the free list, last item first so that
+       they get handed out in address order */
+    for (i = pool->perslab; i > 0; --i) {
+        hdr = PoolSlabItem(slab, pool, i - 1);
+        hdr->slab = slab;
+        PoolNextFree(hdr + 1) = pool->freelist;
+        pool->freelist = (genericptr_t) (hdr + 1);
+    }
+    pool->nfree += pool->perslab;
+}
+
+/* get an item from a pool; contents are unspecified */
+genericptr_t
+nhpool_get(struct nhpool *pool)
+{
+    genericptr_t item;
+
+    if (!pool->gets) { /* first use; make it visible to #stats */
+        pool->nextpool = nhpools;
+        nhpools = pool;
+    }
+#ifdef MONITOR_HEAP
+    item = (genericptr_t) nhalloc(pool->itemsize, __FILE__, (int) __LINE__);
+#else
+    union nhpool_hdr *hdr;
+
+    if (!pool->freelist)
+        nhpool_grow(pool);
+    item = pool->freelist;
+    pool->freelist = PoolNextFree(item);
+    pool->nfree--;
+    hdr = (union nhpool_hdr *) item - 1;
+    hdr->slab->inuse++;
+#endif
+    pool->gets++;
+    if (++pool->inuse > pool->peak)
+        pool->peak = pool->inuse;
+    return item;
+}
+
+/* return an item obtained from nhpool_get() to its pool */
+void
+nhpool_put(struct nhpool *pool, genericptr_t item)
+{
+#ifdef MONITOR_HEAP
+    nhfree(item, __FILE__, (int) __LINE__);
+#else
+    union nhpool_hdr *hdr = (union nhpool_hdr *) item - 1;
+
+    if (!hdr->slab || !hdr->slab->inuse)
+        panic("nhpool_put: %s item %s not in use", pool->name,
+              fmt_ptr(item));
+    hdr->slab->inuse--;
+    PoolNextFree(item) = pool->freelist;
+    pool->freelist = item;
+    pool->nfree++;
+#endif
+    pool->inuse--;
+}
+
+/* release a pool's empty slabs, keeping one in reserve */
+void
+nhpool_trim(struct nhpool *pool)
+{
+    struct nhpool_slab *slab, *nextslab, **prevp;
+    genericptr_t item, nextitem, *tailp;
+    boolean kept = FALSE;
+    long nempty = 0L;
+
+    for (slab = pool->slabs; slab; slab = slab->next)
+        if (!slab->inuse) {
+            /* mark as releasable; inuse can't otherwise be all ones */
+            if (kept)
+                slab->inuse = ~0U, ++nempty;
+            kept = TRUE;
+        }
+    if (!nempty)
+        return;
+
+    /* drop items belonging to releasable slabs from the free list */
+    tailp = &pool->freelist;
+    for (item = pool->freelist; item; item = nextitem) {
+        nextitem = PoolNextFree(item);
+        if (((union nhpool_hdr *) item - 1)->slab->inuse == ~0U) {
+            pool->nfree--;
+        } else {
+            *tailp = item;
+            tailp = &PoolNextFree(item);
+        }
+    }
+    *tailp = (genericptr_t) 0;
+
+    for (prevp = &pool->slabs, slab = pool->slabs; slab; slab = nextslab) {
+        nextslab = slab->next;
+        if (slab->inuse == ~0U) {
+            *prevp = nextslab;
+            free((genericptr_t) slab);
+            pool->nslabs--;
+            pool->released++;
+        } else {
+            prevp = &slab->next;
+        }
+    }
+}
+
+/* trim every pool; called after a level has been freed */
+void
+nhpool_trim_all(void)
+{
+#ifndef MONITOR_HEAP
+    struct nhpool *pool;
+
+    for (pool = nhpools; pool; pool = pool->nextpool)
+        nhpool_trim(pool);
+#endif
+}
+
+/* release every slab of every pool, whether its items are in use or not;
+   called from freedynamicdata() once the objects and monsters are gone */
+void
+nhpool_free_all(void)
+{
+    struct nhpool *pool, *nextpool;
+#ifndef MONITOR_HEAP
+    struct nhpool_slab *slab, *nextslab;
+#endif
+
+    for (pool = nhpools; pool; pool = nextpool) {
+        nextpool = pool->nextpool;
+#ifndef MONITOR_HEAP
+        for (slab = pool->slabs; slab; slab = nextslab) {
+            nextslab = slab->next;
+            free((genericptr_t) slab);
+            pool->released++;
+        }
+#endif
+        pool->slabs = (struct nhpool_slab *) 0;
+        pool->freelist = (genericptr_t) 0;
+        pool->nextpool = (struct nhpool *) 0;
+        pool->nslabs = pool->inuse = pool->nfree = 0L;
+        pool->gets = 0L; /* so that next use puts it back on the list */
+    }
+    nhpools = (struct nhpool *) 0;
+}
+
+/* for #stats: the pools which have been used so far */
+struct nhpool *
+nhpool_list(void)
+{
+    return nhpools;
+}
+
+/* for #stats: memory currently held by a pool, whether in use or not */
+long
+nhpool_bytes(struct nhpool *pool)
+{
+    return pool->nslabs * ((long) sizeof (struct nhpool_slab)
+                           + (long) pool->perslab * PoolItemSpan(pool));
+}
+
 /* cast to int or panic on overflow; use via macro */
 int
 FITSint_(LUA_INTEGER i, const char *file, int line)
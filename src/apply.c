@@ -1798,6 +1798,7 @@ dorub(void)
                but an indebted one who grants a wish might bestow an
                artifact which blasts the hero with lethal results) */
             uwep->otyp = OIL_LAMP;
+            obj_retyped(uwep);
             uwep->spe = 0; /* for safety */
             uwep->age = rn1(500, 1000);
             if (uwep->lamplit)
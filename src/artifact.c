@@ -124,6 +124,16 @@ restore_artifacts(NHFILE *nhfp)
     hack_artifacts();   /* redo non-saved special cases */
 }
 
+#ifdef PREGEN_LEVELS
+/* fold the saved artifact state into a checksum */
+uint64
+artifact_hash(uint64 h)
+{
+    h = hash_bytes(h, (genericptr_t) artiexist, sizeof artiexist);
+    return hash_bytes(h, (genericptr_t) artidisco, sizeof artidisco);
+}
+#endif
+
 const char *
 artiname(int artinum)
 {
@@ -593,6 +593,24 @@ savebones(int how, time_t when, struct obj *corpse)
     compress_bonesfile();
 }
 
+/* should getbones() look for a bones file for the level being made?
+   uses up a random number, so needs to be called at the same point of
+   level creation whether or not getbones() follows */
+boolean
+bones_possible(void)
+{
+    if (discover) /* save bones files for real games */
+        return FALSE;
+
+    if (!flags.bones)
+        return FALSE;
+    /* wizard check added by GAN 02/05/87 */
+    if (rn2(3) /* only once in three times do we find bones */
+        && !wizard)
+        return FALSE;
+    return !no_bones_level(&u.uz);
+}
+
 int
 getbones(void)
 {
@@ -601,16 +619,7 @@ getbones(void)
     char c = 0, *bonesid,
          oldbonesid[40] = { 0 }; /* was [10]; more should be safer */
 
-    if (discover) /* save bones files for real games */
-        return 0;
-
-    if (!flags.bones)
-        return 0;
-    /* wizard check added by GAN 02/05/87 */
-    if (rn2(3) /* only once in three times do we find bones */
-        && !wizard)
-        return 0;
-    if (no_bones_level(&u.uz))
+    if (!bones_possible())
         return 0;
 
     nhfp = open_bonesfile(&u.uz, &bonesid);
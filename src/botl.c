@@ -258,6 +258,7 @@ bot(void)
 {
     if (gb.bot_disabled)
         return;
+    PROF_START(PROF_BOT);
     /* dosave() flags completion by setting u.uhp to -1; suppress_map_output()
        covers program_state.restoring and is used for status as well as map */
     if (u.uhp != -1 && gy.youmonst.data
@@ -272,6 +273,7 @@ bot(void)
         }
     }
     disp.botl = disp.botlx = disp.time_botl = FALSE;
+    PROF_STOP(PROF_BOT);
 }
 
 /* special purpose status update: move counter ('time' status) only */
@@ -700,6 +702,20 @@ static boolean cache_avail[3] = { FALSE, FALSE, FALSE };
 static boolean cache_reslt[3] = { FALSE, FALSE, FALSE };
 static const char *cache_nomovemsg = NULL, *cache_multi_reason = NULL;
 
+/* what the fields which take more than their own value to format were
+   last formatted from; while these stay the same, bot_via_windowport()
+   copies the previous text instead of building it again */
+static struct bl_inputs {
+    boolean valid;    /* False: format everything */
+    int title_mnum;   /* u.umonnum if Upolyd, otherwise NON_PM */
+    int title_ulevel;
+    boolean title_female;
+    d_level uz;       /* for dungeon level description */
+    int gold_rndencode;
+    nhsym gold_sym;
+    boolean gold_invis;
+} bl_inputs;
+
 #define cond_cache_prepA() \
 do {                                                        \
     boolean clear_cache = FALSE, refresh_cache = FALSE;     \
@@ -744,8 +760,9 @@ bot_via_windowport(void)
     char buf[BUFSZ];
     const char *titl;
     char *nb;
-    int i, idx, cap;
+    int i, idx, prv, cap;
     long money;
+    boolean reuse, goldinvis;
 
     if (!gb.blinit)
         panic("bot before init.");
@@ -753,6 +770,15 @@ bot_via_windowport(void)
     /* toggle from previous iteration */
     idx = 1 - gn.now_or_before_idx; /* 0 -> 1, 1 -> 0 */
     gn.now_or_before_idx = idx;
+    prv = 1 - idx;
+    /* status_initialize() sets update_all; other buffer might be stale */
+    if (gu.update_all)
+        bl_inputs.valid = FALSE;
+    reuse = bl_inputs.valid;
+    bl_inputs.valid = TRUE;
+
+#define bl_copyprev(fld) \
+    Strcpy(gb.blstats[idx][(fld)].val, gb.blstats[prv][(fld)].val)
 
     /* clear the "value set" indicators */
     (void) memset((genericptr_t) gv.valset, 0, MAXBLSTATS * sizeof (boolean));
@@ -766,6 +792,15 @@ bot_via_windowport(void)
     /*
      *  Player name and title.
      */
+    if (reuse && bl_inputs.title_mnum == (Upolyd ? u.umonnum : NON_PM)
+        && bl_inputs.title_ulevel == u.ulevel
+        && bl_inputs.title_female == (Ugender != 0)) {
+        bl_copyprev(BL_TITLE);
+        goto title_done;
+    }
+    bl_inputs.title_mnum = Upolyd ? u.umonnum : NON_PM;
+    bl_inputs.title_ulevel = u.ulevel;
+    bl_inputs.title_female = (Ugender != 0);
     Strcpy(nb = buf, gp.plname);
     nb[0] = highc(nb[0]);
     titl = !Upolyd ? rank() : pmname(&mons[u.umonnum], Ugender);
@@ -785,11 +820,16 @@ bot_via_windowport(void)
                 nb[i] = highc(nb[i]);
     }
     Sprintf(gb.blstats[idx][BL_TITLE].val, "%-30s", buf);
+ title_done:
     gv.valset[BL_TITLE] = TRUE; /* indicate val already set */
 
     /* Strength */
     gb.blstats[idx][BL_STR].a.a_int = ACURR(A_STR);
-    Strcpy(gb.blstats[idx][BL_STR].val, get_strength_str());
+    if (reuse && gb.blstats[idx][BL_STR].a.a_int
+                     == gb.blstats[prv][BL_STR].a.a_int)
+        bl_copyprev(BL_STR);
+    else
+        Strcpy(gb.blstats[idx][BL_STR].val, get_strength_str());
     gv.valset[BL_STR] = TRUE; /* indicate val already set */
 
     /*  Dexterity, constitution, intelligence, wisdom, charisma. */
@@ -824,7 +864,12 @@ bot_via_windowport(void)
     gb.blstats[idx][BL_HPMAX].a.a_int = min(i, 9999);
 
     /*  Dungeon level. */
-    (void) describe_level(gb.blstats[idx][BL_LEVELDESC].val, 1);
+    if (reuse && on_level(&bl_inputs.uz, &u.uz)) {
+        bl_copyprev(BL_LEVELDESC);
+    } else {
+        (void) describe_level(gb.blstats[idx][BL_LEVELDESC].val, 1);
+        assign_level(&bl_inputs.uz, &u.uz);
+    }
     gv.valset[BL_LEVELDESC] = TRUE; /* indicate val already set */
 
     /* Gold */
@@ -832,6 +877,17 @@ bot_via_windowport(void)
         money = 0L; /* ought to issue impossible() and then discard gold */
     gb.blstats[idx][BL_GOLD].rawval.a_long = money;
     gb.blstats[idx][BL_GOLD].a.a_long = min(money, 999999L);
+    goldinvis = (iflags.in_dumplog || iflags.invis_goldsym);
+    if (reuse && money == gb.blstats[prv][BL_GOLD].rawval.a_long
+        && bl_inputs.gold_rndencode == gc.context.rndencode
+        && bl_inputs.gold_sym == gs.showsyms[COIN_CLASS + SYM_OFF_O]
+        && bl_inputs.gold_invis == goldinvis) {
+        bl_copyprev(BL_GOLD);
+        goto gold_done;
+    }
+    bl_inputs.gold_rndencode = gc.context.rndencode;
+    bl_inputs.gold_sym = gs.showsyms[COIN_CLASS + SYM_OFF_O];
+    bl_inputs.gold_invis = goldinvis;
     /*
      * The tty port needs to display the current symbol for gold
      * as a field header, so to accommodate that we pass gold with
@@ -848,9 +904,9 @@ bot_via_windowport(void)
      * sequence.
      */
     Sprintf(gb.blstats[idx][BL_GOLD].val, "%s:%ld",
-            (iflags.in_dumplog || iflags.invis_goldsym) ? "$"
-              : encglyph(objnum_to_glyph(GOLD_PIECE)),
+            goldinvis ? "$" : encglyph(objnum_to_glyph(GOLD_PIECE)),
             gb.blstats[idx][BL_GOLD].a.a_long);
+ gold_done:
     gv.valset[BL_GOLD] = TRUE; /* indicate val already set */
 
     /* Power (magical energy) */
@@ -1027,6 +1083,7 @@ bot_via_windowport(void)
 
     evaluate_and_notify_windowport(gv.valset, idx);
 #undef test_if_enabled
+#undef bl_copyprev
 }
 
 #undef cond_cache_prepA
@@ -1931,6 +1931,8 @@ struct ext_func_tab extcmdlist[] = {
     { '\0',   "wizmondiff", "validate the difficulty ratings of monsters",
               wiz_mon_diff, IFBURIED | AUTOCOMPLETE | WIZMODECMD, NULL },
 #endif
+    { '\0',   "wizprofile", "show hot-path timing profile",
+              wiz_profile, IFBURIED | AUTOCOMPLETE | WIZMODECMD, NULL },
     { '\0',   "wizrumorcheck", "verify rumor boundaries",
               wiz_rumor_check, IFBURIED | AUTOCOMPLETE | WIZMODECMD, NULL },
     { '\0',   "wizseenv", "show map locations' seen vectors",
@@ -645,6 +645,26 @@ add_menu_coloring(char *tmpstr) /* never Null but could be empty */
     return add_menu_coloring_parsed(tmps, c, a);
 }
 
+static struct regex_cache menucolor_cache;
+
+/* first menu coloring rule which matches 'str', or Null */
+struct menucoloring *
+menu_coloring_match(const char *str)
+{
+    struct menucoloring *tmpmc = gm.menu_colorings;
+    genericptr_t rule;
+
+    if (!tmpmc)
+        return tmpmc;
+    /* basic_menu_colors() swaps whole lists, changing the first rule */
+    if (regex_cache_find(&menucolor_cache, (genericptr_t) tmpmc, str, &rule))
+        return (struct menucoloring *) rule;
+    while (tmpmc && !regex_match(str, tmpmc->match))
+        tmpmc = tmpmc->next;
+    regex_cache_add(&menucolor_cache, str, (genericptr_t) tmpmc);
+    return tmpmc;
+}
+
 /* release all menu color patterns */
 void
 free_menu_coloring(void)
@@ -663,6 +683,7 @@ free_menu_coloring(void)
         gm.menu_colorings = gc.color_colorings;
         gc.color_colorings = (struct menucoloring *) 0;
     } while (gm.menu_colorings);
+    regex_cache_clear(&menucolor_cache);
 }
 
 /* release a specific menu color pattern; not used for color_colorings */
@@ -672,6 +693,7 @@ free_one_menu_coloring(int idx) /* 0 .. */
     struct menucoloring *tmp = gm.menu_colorings;
     struct menucoloring *prev = NULL;
 
+    regex_cache_clear(&menucolor_cache);
     while (tmp) {
         if (idx == 0) {
             struct menucoloring *next = tmp->next;
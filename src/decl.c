@@ -106,6 +106,10 @@ const schar dirs_ord[N_DIRS] =
 
 NEARDATA boolean has_strong_rngseed = FALSE;
 struct engr *head_engr;
+struct nhpool obj_pool = NHPOOL_INIT("objects", struct obj, 64),
+              oextra_pool = NHPOOL_INIT("oextra", struct oextra, 32),
+              monst_pool = NHPOOL_INIT("monsters", struct monst, 32),
+              mextra_pool = NHPOOL_INIT("mextra", struct mextra, 32);
 NEARDATA struct instance_flags iflags;
 NEARDATA struct accessibility_data a11y;
 /* NOTE: the order of these words exactly corresponds to the
@@ -221,6 +225,9 @@ static const struct instance_globals_a g_init_a = {
 
     /* trap.c */
     { 0, 0, FALSE }, /* acid_ctx */
+    /* windows.c */
+    0L, /* anim_frameno */
+    0UL, /* anim_due */
     TRUE, /* havestate*/
     IVMAGIC  /* a_magic to validate that structure layout has been preserved */
 };
@@ -384,6 +391,8 @@ static const struct instance_globals_f g_init_f = {
     0L, /* false_rumor_end */
     /* shk.c */
     0L, /* followmsg */
+    /* teleport.c */
+    { { 0 }, { { 0 } }, { 0 }, { { 0 } }, 0L, 0, 0, FALSE }, /* freecells */
     TRUE, /* havestate*/
     IVMAGIC  /* f_magic to validate that structure layout has been preserved */
 };
@@ -415,6 +424,9 @@ static const struct instance_globals_g g_init_g = {
     NULL, NULL, NULL, /* gmst_ubak, gmst_disco, gmst_mvitals */
     /* pline.c */
     UNDEFINED_PTR, /* gamelog */
+    UNDEFINED_PTR, /* gamelog_text */
+    0U, 0U, /* gamelog_cnt, gamelog_max */
+    0U, 0U, /* gamelog_textlen, gamelog_textmax */
     /* region.c */
     FALSE, /* gas_cloud_diss_within */
     0, /* gas_cloud_diss_seen */
@@ -458,10 +470,14 @@ static const struct instance_globals_i g_init_i = {
     NULL, /* invbuf */
     0U, /* invbufsize */
     0,       /* in_sync_perminvent */
+    /* mkobj.c */
+    { NULL, NULL, 0U, 0U }, /* oid_index */
+    { NULL, NULL, 0U, 0U }, /* mid_index */
+    0, /* id_index_depth */
     /* mon.c */
     NULL, /* itermonarr */
     /* restore.c */
-    UNDEFINED_PTR, /* id_map */
+    { NULL, NULL, 0U, 0U }, /* id_map */
     /* sp_lev.c */
     FALSE, /* in_mk_themerooms */
 
@@ -495,6 +511,9 @@ static const struct instance_globals_l g_init_l = {
     { { { UNDEFINED_VALUES } }, /* level.locations */
       { { UNDEFINED_PTR } },    /* level.objects   */
       { { UNDEFINED_PTR } },    /* level.monsters  */
+      { { UNDEFINED_PTR } },    /* level.traps     */
+      { { UNDEFINED_PTR } },    /* level.engravings */
+      { { UNDEFINED_PTR } },    /* level.stairways */
       NULL, NULL, NULL, NULL, NULL, {0} }, /* level */
 #if defined(UNIX) || defined(VMS)
     0, /* locknum */
@@ -505,6 +524,9 @@ static const struct instance_globals_l g_init_l = {
     /* files.c */
     UNDEFINED_VALUE, /* lockptr */
     LOCKNAMEINIT, /* lock */
+    NULL, /* livelog_queue */
+    0, 0, /* livelog_qlen, livelog_qmax */
+    0, /* livelog_qtime */
     /* invent.c */
     51, /* lastinvr */
     /* light.c */
@@ -612,7 +634,6 @@ static const struct instance_globals_n g_init_n = {
     /* mhitm.c */
     0L, /* noisetime */
     /* mkmap.c */
-    UNDEFINED_PTR, /* new_locations */
     UNDEFINED_VALUE, /* n_loc_filled */
     /* options.c */
     0, /* n_menu_mapped */
@@ -622,8 +643,6 @@ static const struct instance_globals_n g_init_n = {
     UNDEFINED_VALUES, /* nambuf */
     /* region.c */
     0, /* n_regions */
-    /* restore.c */
-    0, /* n_ids_mapped */
     /* sp_lev.c */
     0, /* num_lregions */
     /* u_init.c */
@@ -786,7 +805,7 @@ static const struct instance_globals_s g_init_s = {
     /* pline.c */
 #ifdef DUMPLOG_CORE
     0U, /* saved_pline_index */
-    { NULL }, /* saved_plines */
+    { { 0 } }, /* saved_plines */
 #endif
     /* polyself.c */
     0, /* sex_change_ok */
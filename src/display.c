@@ -130,7 +130,7 @@ staticfn int swallow_to_glyph(int, int);
 staticfn void display_warning(struct monst *) NONNULLARG1;
 staticfn boolean next_to_gas(struct monst *, coordxy, coordxy) NONNULLARG1;
 
-staticfn int check_pos(coordxy, coordxy, int);
+staticfn int wall_open_nbrs(coordxy, coordxy);
 staticfn void get_bkglyph_and_framecolor(coordxy x, coordxy y, int *, uint32 *);
 staticfn int tether_glyph(coordxy, coordxy);
 staticfn void mimic_light_blocking(struct monst *) NONNULLARG1;
@@ -140,12 +140,14 @@ staticfn void mimic_light_blocking(struct monst *) NONNULLARG1;
 staticfn boolean more_than_one(coordxy, coordxy, coordxy, coordxy, coordxy);
 #endif
 
-staticfn int set_twall(coordxy, coordxy, coordxy, coordxy,
-                     coordxy, coordxy, coordxy, coordxy);
-staticfn int set_wall(coordxy, coordxy, int);
-staticfn int set_corn(coordxy, coordxy, coordxy, coordxy,
-                    coordxy, coordxy, coordxy, coordxy);
-staticfn int set_crosswall(coordxy, coordxy);
+staticfn int set_twall(coordxy, coordxy, int, int, int, int);
+staticfn int set_wall(coordxy, coordxy, int, int);
+staticfn int set_corn(int, int, int, int, int);
+staticfn int set_crosswall(coordxy, coordxy, int);
+staticfn int wall_mode(coordxy, coordxy, int, int);
+#ifndef WA_VERBOSE
+staticfn void init_wall_modes(void);
+#endif
 staticfn void set_seenv(struct rm *, coordxy, coordxy, coordxy, coordxy);
 staticfn void t_warn(struct rm *);
 staticfn int wall_angle(struct rm *);
@@ -2167,6 +2169,7 @@ flush_screen(int cursor_on_u)
     if (gp.program_state.done_hup)
         return;
 #endif
+    PROF_START(PROF_FLUSH);
 
     /* get this done now, before we place the cursor on the hero */
     if (disp.botl || disp.botlx)
@@ -2197,6 +2200,7 @@ flush_screen(int cursor_on_u)
         curs(WIN_MAP, u.ux, u.uy); /* move cursor to the hero */
 
     display_nhwindow(WIN_MAP, FALSE);
+    PROF_STOP(PROF_FLUSH);
     flushing = 0;
 }
 
@@ -3055,24 +3059,36 @@ error4(coordxy x, coordxy y, int a, int b, int c, int dd)
 #endif /* WA_VERBOSE */
 
 /*
- * Return 'which' if position is implies an unfinished exterior.  Return
- * zero otherwise.  Unfinished implies outer area is rock or a corridor.
+ * Return a WN_xx mask (see rm.h) of the locations around <x,y> which
+ * imply an unfinished exterior.  Unfinished implies outer area is rock
+ * or a corridor; off the map counts too.
  *
  * Things that are ambiguous: lava
  */
 staticfn int
-check_pos(coordxy x, coordxy y, int which)
+wall_open_nbrs(coordxy x, coordxy y)
 {
-    int type;
+    static const schar wn_dx[8] = { -1, 0, 1, 1, 1, 0, -1, -1 },
+                       wn_dy[8] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+    coordxy nx, ny;
+    int i, type, mask = 0;
 
-    if (!isok(x, y))
-        return which;
-    type = levl[x][y].typ;
-    if (IS_ROCK(type) || type == CORR || type == SCORR)
-        return which;
-    return 0;
+    for (i = 0; i < 8; i++) {
+        nx = x + wn_dx[i], ny = y + wn_dy[i];
+        if (!isok(nx, ny)) {
+            mask |= 1 << i;
+            continue;
+        }
+        type = levl[nx][ny].typ;
+        if (IS_ROCK(type) || type == CORR || type == SCORR)
+            mask |= 1 << i;
+    }
+    return mask;
 }
 
+/* 'which' if neighbour 'bit' is unfinished, otherwise 0 */
+#define check_pos(mask, bit, which) (((mask) & (bit)) ? (which) : 0)
+
 /* Return TRUE if more than one is non-zero. */
 /*ARGSUSED*/
 #ifdef WA_VERBOSE
@@ -3098,13 +3114,13 @@ set_twall(
 #else
           coordxy x0 UNUSED, coordxy y0 UNUSED,
 #endif
-          coordxy x1, coordxy y1, coordxy x2, coordxy y2, coordxy x3, coordxy y3)
+          int mask, int bit1, int bit2, int bit3)
 {
     int wmode, is_1, is_2, is_3;
 
-    is_1 = check_pos(x1, y1, WM_T_LONG);
-    is_2 = check_pos(x2, y2, WM_T_BL);
-    is_3 = check_pos(x3, y3, WM_T_BR);
+    is_1 = check_pos(mask, bit1, WM_T_LONG);
+    is_2 = check_pos(mask, bit2, WM_T_BL);
+    is_3 = check_pos(mask, bit3, WM_T_BR);
     if (more_than_one(x0, y0, is_1, is_2, is_3)) {
         wmode = 0;
     } else {
@@ -3115,16 +3131,22 @@ set_twall(
 
 /* Return wall mode for a horizontal or vertical wall. */
 staticfn int
-set_wall(coordxy x, coordxy y, int horiz)
+set_wall(
+#ifdef WA_VERBOSE
+         coordxy x, coordxy y, /* used #if WA_VERBOSE */
+#else
+         coordxy x UNUSED, coordxy y UNUSED,
+#endif
+         int mask, int horiz)
 {
     int wmode, is_1, is_2;
 
     if (horiz) {
-        is_1 = check_pos(x, y - 1, WM_W_TOP);
-        is_2 = check_pos(x, y + 1, WM_W_BOTTOM);
+        is_1 = check_pos(mask, WN_T, WM_W_TOP);
+        is_2 = check_pos(mask, WN_B, WM_W_BOTTOM);
     } else {
-        is_1 = check_pos(x - 1, y, WM_W_LEFT);
-        is_2 = check_pos(x + 1, y, WM_W_RIGHT);
+        is_1 = check_pos(mask, WN_L, WM_W_LEFT);
+        is_2 = check_pos(mask, WN_R, WM_W_RIGHT);
     }
     if (more_than_one(x, y, is_1, is_2, 0)) {
         wmode = 0;
@@ -3134,16 +3156,16 @@ set_wall(coordxy x, coordxy y, int horiz)
     return wmode;
 }
 
-/* Return a wall mode for a corner wall. (x4,y4) is the "inner" position. */
+/* Return a wall mode for a corner wall. bit4 is the "inner" position. */
 staticfn int
-set_corn(coordxy x1, coordxy y1, coordxy x2, coordxy y2, coordxy x3, coordxy y3, coordxy x4, coordxy y4)
+set_corn(int mask, int bit1, int bit2, int bit3, int bit4)
 {
-    coordxy wmode, is_1, is_2, is_3, is_4;
+    int wmode, is_1, is_2, is_3, is_4;
 
-    is_1 = check_pos(x1, y1, 1);
-    is_2 = check_pos(x2, y2, 1);
-    is_3 = check_pos(x3, y3, 1);
-    is_4 = check_pos(x4, y4, 1); /* inner location */
+    is_1 = check_pos(mask, bit1, 1);
+    is_2 = check_pos(mask, bit2, 1);
+    is_3 = check_pos(mask, bit3, 1);
+    is_4 = check_pos(mask, bit4, 1); /* inner location */
 
     /*
      * All 4 should not be true.  So if the inner location is rock,
@@ -3164,14 +3186,20 @@ set_corn(coordxy x1, coordxy y1, coordxy x2, coordxy y2, coordxy x3, coordxy y3,
 
 /* Return mode for a crosswall. */
 staticfn int
-set_crosswall(coordxy x, coordxy y)
+set_crosswall(
+#ifdef WA_VERBOSE
+              coordxy x, coordxy y, /* used #if WA_VERBOSE */
+#else
+              coordxy x UNUSED, coordxy y UNUSED,
+#endif
+              int mask)
 {
-    coordxy wmode, is_1, is_2, is_3, is_4;
+    int wmode, is_1, is_2, is_3, is_4;
 
-    is_1 = check_pos(x - 1, y - 1, 1);
-    is_2 = check_pos(x + 1, y - 1, 1);
-    is_3 = check_pos(x + 1, y + 1, 1);
-    is_4 = check_pos(x - 1, y + 1, 1);
+    is_1 = check_pos(mask, WN_TL, 1);
+    is_2 = check_pos(mask, WN_TR, 1);
+    is_3 = check_pos(mask, WN_BR, 1);
+    is_4 = check_pos(mask, WN_BL, 1);
 
     wmode = is_1 + is_2 + is_3 + is_4;
     if (wmode > 1) {
@@ -3197,75 +3225,113 @@ set_crosswall(coordxy x, coordxy y)
     return wmode;
 }
 
-/* called for every <x,y> by set_wall_state() and for specific <x,y> during
-   vault wall repair */
-void
-xy_set_wall_state(coordxy x, coordxy y)
-{
-    coordxy wmode;
-    struct rm *lev = &levl[x][y];
+#undef check_pos
 
-    switch (lev->typ) {
-    case SDOOR:
-        wmode = set_wall(x, y, (coordxy) lev->horizontal);
-        break;
+/* wall mode for wall type 'typ' (VWALL through TRWALL) with unfinished
+   neighbours 'mask'; <x,y> is only used for WA_VERBOSE diagnostics */
+staticfn int
+wall_mode(coordxy x, coordxy y, int typ, int mask)
+{
+    switch (typ) {
     case VWALL:
-        wmode = set_wall(x, y, 0);
-        break;
+        return set_wall(x, y, mask, 0);
     case HWALL:
-        wmode = set_wall(x, y, 1);
-        break;
+        return set_wall(x, y, mask, 1);
     case TDWALL:
-        wmode = set_twall(x, y, x, y - 1, x - 1, y + 1, x + 1, y + 1);
-        break;
+        return set_twall(x, y, mask, WN_T, WN_BL, WN_BR);
     case TUWALL:
-        wmode = set_twall(x, y, x, y + 1, x + 1, y - 1, x - 1, y - 1);
-        break;
+        return set_twall(x, y, mask, WN_B, WN_TR, WN_TL);
     case TLWALL:
-        wmode = set_twall(x, y, x + 1, y, x - 1, y - 1, x - 1, y + 1);
-        break;
+        return set_twall(x, y, mask, WN_R, WN_TL, WN_BL);
     case TRWALL:
-        wmode = set_twall(x, y, x - 1, y, x + 1, y + 1, x + 1, y - 1);
-        break;
+        return set_twall(x, y, mask, WN_L, WN_BR, WN_TR);
     case TLCORNER:
-        wmode = set_corn(x - 1, y - 1, x, y - 1, x - 1, y, x + 1, y + 1);
-        break;
+        return set_corn(mask, WN_TL, WN_T, WN_L, WN_BR);
     case TRCORNER:
-        wmode = set_corn(x, y - 1, x + 1, y - 1, x + 1, y, x - 1, y + 1);
-        break;
+        return set_corn(mask, WN_T, WN_TR, WN_R, WN_BL);
     case BLCORNER:
-        wmode = set_corn(x, y + 1, x - 1, y + 1, x - 1, y, x + 1, y - 1);
-        break;
+        return set_corn(mask, WN_B, WN_BL, WN_L, WN_TR);
     case BRCORNER:
-        wmode = set_corn(x + 1, y, x + 1, y + 1, x, y + 1, x - 1, y - 1);
-        break;
+        return set_corn(mask, WN_R, WN_BR, WN_B, WN_TL);
     case CROSSWALL:
-        wmode = set_crosswall(x, y);
-        break;
-
+        return set_crosswall(x, y, mask);
     default:
-        wmode = -1; /* don't set wall info */
         break;
     }
+    return 0;
+}
 
-    if (wmode >= 0)
-        lev->wall_info = (lev->wall_info & ~WM_MASK) | wmode;
+#ifndef WA_VERBOSE
+/* wall mode for every wall type and neighbour mask, so that setting
+   a wall's mode is one lookup; WA_VERBOSE skips this to be able to
+   report the location of problems */
+static schar wall_modes[TRWALL - VWALL + 1][256];
+static boolean wall_modes_ready = FALSE;
+
+staticfn void
+init_wall_modes(void)
+{
+    int typ, mask;
+
+    for (typ = VWALL; typ <= TRWALL; typ++)
+        for (mask = 0; mask < 256; mask++)
+            wall_modes[typ - VWALL][mask]
+                = (schar) wall_mode(0, 0, typ, mask);
+    wall_modes_ready = TRUE;
+}
+#endif /* !WA_VERBOSE */
+
+/* called for every <x,y> by set_wall_state() and for specific <x,y> during
+   vault wall repair */
+void
+xy_set_wall_state(coordxy x, coordxy y)
+{
+    int typ, mask, wmode;
+    struct rm *lev = &levl[x][y];
+
+    typ = lev->typ;
+    if (typ == SDOOR)
+        typ = lev->horizontal ? HWALL : VWALL;
+    else if (typ < VWALL || typ > TRWALL)
+        return; /* don't set wall info */
+
+    mask = wall_open_nbrs(x, y);
+#ifdef WA_VERBOSE
+    wmode = wall_mode(x, y, typ, mask);
+#else
+    if (!wall_modes_ready)
+        init_wall_modes();
+    wmode = wall_modes[typ - VWALL][mask];
+#endif
+    lev->wall_info = (lev->wall_info & ~WM_MASK) | wmode;
+}
+
+/* set the wall modes for the walls in a rectangle, after the terrain
+   there (or next to it) has changed */
+void
+set_wall_state_area(coordxy x1, coordxy y1, coordxy x2, coordxy y2)
+{
+    coordxy x, y;
+
+    x1 = max(x1, 0), y1 = max(y1, 0);
+    x2 = min(x2, COLNO - 1), y2 = min(y2, ROWNO - 1);
+    for (x = x1; x <= x2; x++)
+        for (y = y1; y <= y2; y++)
+            xy_set_wall_state(x, y);
 }
 
 /* Called from mklev.  Scan the level and set the wall modes. */
 void
 set_wall_state(void)
 {
+#ifdef WA_VERBOSE
     coordxy x, y;
 
-#ifdef WA_VERBOSE
     for (x = 0; x < MAX_TYPE; x++)
         bad_count[x] = 0;
 #endif
 
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            xy_set_wall_state(x, y);
+    set_wall_state_area(0, 0, COLNO - 1, ROWNO - 1);
 
 #ifdef WA_VERBOSE
     /* check if any bad positions found */
@@ -3708,6 +3774,54 @@ wall_angle(struct rm *lev)
     return idx;
 }
 
+/*
+ * Copy the map locations in the rectangle <x1,y1> to <x2,y2>, inclusive,
+ * into cells[], a row at a time.  cells[] needs room for
+ * (x2 - x1 + 1) * (y2 - y1 + 1) entries.  Returns the number of cells
+ * copied, or -1 if the rectangle isn't entirely on the map.
+ *
+ * This gives Lua scripts and programs embedding the game (libnh) the
+ * whole map in one call instead of one nh.getmap() table per location.
+ */
+int
+map_snapshot(
+    struct map_cell *cells,
+    coordxy x1, coordxy y1,
+    coordxy x2, coordxy y2)
+{
+    struct map_cell *cell;
+    struct rm *lev;
+    struct trap *t;
+    coordxy x, y;
+    int w = x2 - x1 + 1;
+
+    if (!isok(x1, y1) || !isok(x2, y2) || x1 > x2 || y1 > y2)
+        return -1;
+
+    for (y = y1; y <= y2; ++y)
+        for (x = x1; x <= x2; ++x) {
+            cell = &cells[(y - y1) * w + (x - x1)];
+            lev = &levl[x][y];
+            cell->glyph = lev->glyph;
+            cell->typ = lev->typ;
+            cell->seenv = lev->seenv;
+            cell->flags = lev->flags;
+            cell->ttyp = NO_TRAP;
+            cell->bits = (lev->lit ? MAPCELL_LIT : 0)
+                         | (lev->waslit ? MAPCELL_WASLIT : 0)
+                         | (lev->horizontal ? MAPCELL_HORIZONTAL : 0)
+                         | (gl.level.monsters[x][y] ? MAPCELL_MONSTER : 0)
+                         | (gl.level.objects[x][y] ? MAPCELL_OBJECT : 0)
+                         | (u_at(x, y) ? MAPCELL_HERO : 0);
+        }
+    /* one pass over the trap list rather than t_at() for every spot */
+    for (t = gf.ftrap; t; t = t->ntrap)
+        if (t->tx >= x1 && t->tx <= x2 && t->ty >= y1 && t->ty <= y2)
+            cells[(t->ty - y1) * w + (t->tx - x1)].ttyp = (uchar) t->ttyp;
+
+    return w * (y2 - y1 + 1);
+}
+
 /*
  * c++ 20 has problems with some of the display.h macros because
  * comparisons and bit-fiddling and math between different enums
@@ -8,6 +8,11 @@
 #ifdef __DJGPP__
 #include <string.h>
 #endif
+#ifdef DLB_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
 
 #define DATAPREFIX 4        /* see decl.h */
 
@@ -61,6 +66,7 @@ extern unsigned FITSuint_(unsigned long long, const char *, int);
 #define MAX_LIBS 4
 staticfn library dlb_libs[MAX_LIBS];
 
+staticfn unsigned dlb_hash(const char *name);
 staticfn boolean readlibdir(library * lp);
 staticfn boolean find_file(const char *name, library **lib, long *startp,
                          long *sizep);
@@ -116,6 +122,25 @@ extern char *eos(char *);
 #define DLB_MIN_VERS 1 /* min library version readable by this code */
 #define DLB_MAX_VERS 1 /* max library version readable by this code */
 
+/* hash of a file name for the directory hash table; ignores case so that
+   names which differ only in case under a case-insensitive FILENAME_CMP
+   land in the same place */
+staticfn unsigned
+dlb_hash(const char *name)
+{
+    unsigned h = 2166136261U;
+    char c;
+
+    for (; *name; ++name) {
+        c = *name;
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        h ^= (unsigned) (unsigned char) c;
+        h *= 16777619U;
+    }
+    return h;
+}
+
 /*
  * Read the directory from the library file.   This will allocate and
  * fill in our globals.  The file pointer is reset back to position
@@ -126,10 +151,11 @@ extern char *eos(char *);
 staticfn boolean
 readlibdir(library *lp) /* library pointer to fill in */
 {
-    int i;
+    int i, j;
     char *sp;
-    long liboffset, totalsize;
+    long liboffset, totalsize, hashsize;
 
+    lp->hash = (int *) 0;
     if (fscanf(lp->fdata, "%ld %ld %ld %ld %ld\n", &lp->rev, &lp->nentries,
                &lp->strsize, &liboffset, &totalsize) != 5)
         return FALSE;
@@ -161,6 +187,24 @@ readlibdir(library *lp) /* library pointer to fill in */
             lp->dir[i].fsize = lp->dir[i + 1].foffset - lp->dir[i].foffset;
     }
 
+    /* hash the names, open addressing with a load factor of at most 1/2;
+       when a name occurs more than once, the first one is used */
+    for (hashsize = 16; hashsize < 2 * lp->nentries; hashsize <<= 1)
+        continue;
+    lp->hash = (int *) alloc(FITSuint(hashsize * sizeof (int)));
+    lp->hashmask = hashsize - 1;
+    for (j = 0; j < hashsize; j++)
+        lp->hash[j] = -1;
+    for (i = 0; i < lp->nentries; i++) {
+        for (j = (int) (dlb_hash(lp->dir[i].fname) & lp->hashmask);
+             lp->hash[j] >= 0; j = (int) ((j + 1) & lp->hashmask))
+            if (FILENAME_CMP(lp->dir[i].fname,
+                             lp->dir[lp->hash[j]].fname) == 0)
+                break;
+        if (lp->hash[j] < 0)
+            lp->hash[j] = i;
+    }
+
     (void) fseek(lp->fdata, 0L, SEEK_SET); /* reset back to zero */
     lp->fmark = 0;
 
@@ -174,16 +218,18 @@ readlibdir(library *lp) /* library pointer to fill in */
 staticfn boolean
 find_file(const char *name, library **lib, long *startp, long *sizep)
 {
-    int i, j;
+    int i, j, k;
+    unsigned h = dlb_hash(name);
     library *lp;
 
     for (i = 0; i < MAX_LIBS && dlb_libs[i].fdata; i++) {
         lp = &dlb_libs[i];
-        for (j = 0; j < lp->nentries; j++) {
-            if (FILENAME_CMP(name, lp->dir[j].fname) == 0) {
+        for (j = (int) (h & lp->hashmask); (k = lp->hash[j]) >= 0;
+             j = (int) ((j + 1) & lp->hashmask)) {
+            if (FILENAME_CMP(name, lp->dir[k].fname) == 0) {
                 *lib = lp;
-                *startp = lp->dir[j].foffset;
-                *sizep = lp->dir[j].fsize;
+                *startp = lp->dir[k].foffset;
+                *sizep = lp->dir[k].fsize;
                 return TRUE;
             }
         }
@@ -202,10 +248,31 @@ open_library(const char *lib_name, library *lp)
 {
     boolean status = FALSE;
 
+#ifdef DLB_MMAP
+    lp->map = (const char *) 0;
+    lp->mapsize = 0L;
+#endif
     lp->fdata = fopen_datafile(lib_name, RDBMODE, DATAPREFIX);
     if (lp->fdata) {
         if (readlibdir(lp)) {
             status = TRUE;
+#ifdef DLB_MMAP
+            {
+                struct stat st;
+                genericptr_t m;
+
+                /* stdio is still there to fall back on if this fails */
+                if (fstat(fileno(lp->fdata), &st) == 0 && st.st_size > 0) {
+                    m = mmap((genericptr_t) 0, (size_t) st.st_size,
+                             PROT_READ, MAP_SHARED, fileno(lp->fdata),
+                             (off_t) 0);
+                    if (m != MAP_FAILED) {
+                        lp->map = (const char *) m;
+                        lp->mapsize = (long) st.st_size;
+                    }
+                }
+            }
+#endif
         } else {
             (void) fclose(lp->fdata);
             lp->fdata = (FILE *) 0;
@@ -217,9 +284,14 @@ open_library(const char *lib_name, library *lp)
 void
 close_library(library *lp)
 {
+#ifdef DLB_MMAP
+    if (lp->map)
+        (void) munmap((genericptr_t) lp->map, (size_t) lp->mapsize);
+#endif
     (void) fclose(lp->fdata);
     free((genericptr_t) lp->dir);
     free((genericptr_t) lp->sspace);
+    free((genericptr_t) lp->hash);
 
     (void) memset((char *) lp, 0, sizeof(library));
 }
@@ -281,6 +353,11 @@ lib_dlb_fopen(dlb *dp, const char *name, const char *mode UNUSED)
         dp->start = start;
         dp->size = size;
         dp->mark = 0;
+        dp->data = (const char *) 0;
+#ifdef DLB_MMAP
+        if (lp->map && start >= 0 && size >= 0 && start + size <= lp->mapsize)
+            dp->data = lp->map + start;
+#endif
         return TRUE;
     }
 
@@ -306,6 +383,14 @@ lib_dlb_fread(char *buf, int size, int quan, dlb *dp)
     if (quan == 0)
         return 0;
 
+    if (dp->data) {
+        nbytes = (long) size * quan;
+        (void) memcpy((genericptr_t) buf, dp->data + dp->mark,
+                      (size_t) nbytes);
+        dp->mark += nbytes;
+        return quan;
+    }
+
     pos = dp->start + dp->mark;
     if (dp->lib->fmark != pos) {
         fseek(dp->lib->fdata, pos, SEEK_SET); /* check for error??? */
@@ -359,11 +444,24 @@ lib_dlb_fgets(char *buf, int len, dlb *dp)
         return (char *) 0;
 
     len--; /* save room for null */
-    for (i = 0, bp = buf; i < len && dp->mark < dp->size && c != '\n';
-         i++, bp++) {
-        if (dlb_fread(bp, 1, 1, dp) <= 0)
-            break; /* EOF or error */
-        c = *bp;
+    if (dp->data) {
+        /* copy up to and including the newline in one go */
+        const char *p = dp->data + dp->mark, *nl;
+
+        i = (dp->size - dp->mark < (long) len) ? (int) (dp->size - dp->mark)
+                                               : len;
+        if ((nl = (const char *) memchr(p, '\n', (size_t) i)) != 0)
+            i = (int) (nl - p) + 1;
+        (void) memcpy((genericptr_t) buf, p, (size_t) i);
+        dp->mark += i;
+        bp = buf + i;
+    } else {
+        for (i = 0, bp = buf; i < len && dp->mark < dp->size && c != '\n';
+             i++, bp++) {
+            if (dlb_fread(bp, 1, 1, dp) <= 0)
+                break; /* EOF or error */
+            c = *bp;
+        }
     }
     *bp = '\0';
 
@@ -382,6 +480,12 @@ lib_dlb_fgetc(dlb *dp)
 {
     char c;
 
+    if (dp->data) {
+        if (dp->mark >= dp->size)
+            return EOF;
+        c = dp->data[dp->mark++];
+        return (int) c;
+    }
     if (lib_dlb_fread(&c, 1, 1, dp) != 1)
         return EOF;
     return (int) c;
@@ -545,6 +649,22 @@ dlb_ftell(dlb *dp)
     return do_dlb_ftell(dp);
 }
 
+/* the whole of a file from a library which is mapped into memory, for
+   use in place; Null if the file has to be read instead */
+const char *
+dlb_fmap(dlb *dp, long *sizep)
+{
+    if (!dlb_initialized || dp->fp)
+        return (const char *) 0;
+#ifdef DLBLIB
+    if (dp->data) {
+        *sizep = dp->size;
+        return dp->data;
+    }
+#endif
+    return (const char *) 0;
+}
+
 #endif /* DLB */
 
 /*dlb.c*/
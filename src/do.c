@@ -1314,6 +1314,20 @@ doup(void)
     return ECMD_TIME;
 }
 
+/* update the deepest level reached in the hero's current dungeon */
+void
+record_dunlev_reached(void)
+{
+    if (!builds_up(&u.uz)) { /* usual case */
+        if (dunlev(&u.uz) > dunlev_reached(&u.uz))
+            dunlev_reached(&u.uz) = dunlev(&u.uz);
+    } else {
+        if (dunlev_reached(&u.uz) == 0
+            || dunlev(&u.uz) < dunlev_reached(&u.uz))
+            dunlev_reached(&u.uz) = dunlev(&u.uz);
+    }
+}
+
 /* check that we can write out the current level */
 staticfn NHFILE *
 currentlevel_rewrite(void)
@@ -1469,6 +1483,7 @@ goto_level(
     boolean do_fall_dmg = FALSE;
     schar prev_temperature = gl.level.flags.temperature;
 
+    livelog_flush(TRUE); /* write out whatever happened on the old level */
     if (dunlev(newlevel) > dunlevs_in_dungeon(newlevel))
         newlevel->dlevel = dunlevs_in_dungeon(newlevel);
     if (newdungeon) {
@@ -1646,14 +1661,7 @@ goto_level(
     assign_level(&u.uz, newlevel);
     assign_level(&u.utolev, newlevel);
     u.utotype = UTOTYPE_NONE;
-    if (!builds_up(&u.uz)) { /* usual case */
-        if (dunlev(&u.uz) > dunlev_reached(&u.uz))
-            dunlev_reached(&u.uz) = dunlev(&u.uz);
-    } else {
-        if (dunlev_reached(&u.uz) == 0
-            || dunlev(&u.uz) < dunlev_reached(&u.uz))
-            dunlev_reached(&u.uz) = dunlev(&u.uz);
-    }
+    record_dunlev_reached();
 
     stairway_free_all();
     /* set default level change destination areas */
@@ -1667,7 +1675,10 @@ goto_level(
             impossible("goto_level: returning to discarded level?");
             gl.level_info[new_ledger].flags &= ~(VISITED);
         }
-        mklev();
+#ifdef PREGEN_LEVELS
+        if (!pregen_load_level(new_ledger))
+#endif
+            mklev();
         new = TRUE; /* made the level */
         familiar = bones_include_name(gp.plname);
     } else {
@@ -1684,6 +1695,9 @@ goto_level(
         close_nhfile(nhfp);
         oinit(); /* reassign level dependent obj probabilities */
     }
+    /* old level's objects and monsters went back to their pools when it
+       was saved; release whatever slabs the new level didn't reuse */
+    nhpool_trim_all();
     reglyph_darkroom();
     set_uinwater(0); /* u.uinwater = 0 */
     /* do this prior to level-change pline messages */
@@ -398,7 +398,25 @@ panic VA_DECL(const char *, str)
     if (gp.program_state.panicking++)
         NH_abort(NULL); /* avoid loops - this should never happen*/
 
+#ifdef PREGEN_LEVELS
+    if (gp.program_state.pregen_helper) {
+        /* level helper has no screen and nothing to save; the game
+           that forked it will make the level itself */
+        (void) vsnprintf(buf, sizeof buf, str, VA_ARGS);
+        paniclog("pregen", buf);
+        _exit(EXIT_FAILURE);
+    }
+#endif
+#ifdef FUZZ_SNAPSHOTS
+    if (gp.program_state.fuzz_worker) {
+        /* impossible() gets here too when fuzzing */
+        (void) vsnprintf(buf, sizeof buf, str, VA_ARGS);
+        fuzz_crash(gp.program_state.in_impossible ? "impossible" : "panic",
+                   buf);
+    }
+#endif
     gb.bot_disabled = TRUE;
+    livelog_flush(TRUE); /* don't lose queued livelog entries */
     if (iflags.window_inited) {
         raw_print("\r\nOops...");
         wait_synch(); /* make sure all pending output gets flushed */
@@ -516,19 +534,16 @@ staticfn void
 dump_plines(void)
 {
     int i, j;
-    char buf[BUFSZ], **strp;
+    char buf[BUFSZ], *strp;
 
     Strcpy(buf, " "); /* one space for indentation */
     putstr(0, 0, "Latest messages:");
     for (i = 0, j = (int) gs.saved_pline_index; i < DUMPLOG_MSG_COUNT;
          ++i, j = (j + 1) % DUMPLOG_MSG_COUNT) {
-        strp = &gs.saved_plines[j];
+        strp = gs.saved_plines[j];
         if (*strp) {
-            copynchars(&buf[1], *strp, BUFSZ - 1 - 1);
+            copynchars(&buf[1], strp, BUFSZ - 1 - 1);
             putstr(0, 0, buf);
-#ifdef FREE_ALL_MEMORY
-            free(*strp), *strp = 0;
-#endif
         }
     }
 }
@@ -1125,6 +1140,11 @@ really_done(int how)
     long umoney;
     long tmp;
 
+#ifdef FUZZ_SNAPSHOTS
+    /* no bones, record, or log entries from a fuzz worker's run */
+    if (gp.program_state.fuzz_worker)
+        fuzz_worker_done(EXIT_SUCCESS);
+#endif
     /*
      *  The game is now over...
      */
@@ -1660,6 +1680,7 @@ nh_terminate(int status)
     gp.program_state.in_moveloop = 0; /* won't be returning to normal play */
 
     l_nhcore_call(NHCORE_GAME_EXIT);
+    livelog_flush(TRUE);
 #ifdef MAC
     getreturn("to exit");
 #endif
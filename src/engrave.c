@@ -226,14 +226,25 @@ cant_reach_floor(coordxy x, coordxy y, boolean up, boolean check_pit)
 struct engr *
 engr_at(coordxy x, coordxy y)
 {
-    struct engr *ep = head_engr;
+    if (!isok(x, y))
+        return (struct engr *) 0;
+    return gl.level.engravings[x][y];
+}
 
-    while (ep) {
-        if (x == ep->engr_x && y == ep->engr_y)
-            return ep;
-        ep = ep->nxt_engr;
-    }
-    return (struct engr *) 0;
+/* rebuild the location index for the engravings on this level */
+void
+reindex_engravings(void)
+{
+    struct engr *ep;
+    coordxy x, y;
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            gl.level.engravings[x][y] = (struct engr *) 0;
+    for (ep = head_engr; ep; ep = ep->nxt_engr)
+        if (isok(ep->engr_x, ep->engr_y)
+            && !gl.level.engravings[ep->engr_x][ep->engr_y])
+            gl.level.engravings[ep->engr_x][ep->engr_y] = ep;
 }
 
 /* Decide whether a particular string is engraved at a specified
@@ -381,6 +392,7 @@ make_engr_at(
     head_engr = ep;
     ep->engr_x = x;
     ep->engr_y = y;
+    gl.level.engravings[x][y] = ep;
     ep->engr_txt[actual_text] = (char *) (ep + 1);
     ep->engr_txt[remembered_text] = ep->engr_txt[actual_text] + smem;
     ep->engr_txt[pristine_text] = ep->engr_txt[remembered_text] + smem;
@@ -1411,6 +1423,8 @@ engraving_sanity_check(void)
             impossible("engraving sanity: !isok <%i,%i>", x, y);
             continue;
         }
+        if (gl.level.engravings[x][y] != ep)
+            impossible("engraving sanity: not indexed at <%i,%i>", x, y);
         levtyp = SURFACE_AT(x, y);
         if (is_pool_or_lava(x, y) || IS_AIR(levtyp) || !ACCESSIBLE(levtyp)) {
             impossible("engraving sanity: illegal surface (%d: \"%s\")",
@@ -1459,8 +1473,10 @@ rest_engravings(NHFILE *nhfp)
         if (nhfp->structlevel)
             mread(nhfp->fd, (genericptr_t) &lth, sizeof(unsigned));
 
-        if (lth == 0)
+        if (lth == 0) {
+            reindex_engravings();
             return;
+        }
         ep = newengr(lth);
         if (nhfp->structlevel) {
             mread(nhfp->fd, (genericptr_t) ep, sizeof(struct engr) + lth);
@@ -1521,6 +1537,9 @@ del_engr(struct engr *ep)
             return;
         }
     }
+    if (isok(ep->engr_x, ep->engr_y)
+        && gl.level.engravings[ep->engr_x][ep->engr_y] == ep)
+        gl.level.engravings[ep->engr_x][ep->engr_y] = (struct engr *) 0;
     dealloc_engr(ep);
 }
 
@@ -1537,8 +1556,12 @@ rloc_engr(struct engr *ep)
         ty = rn2(ROWNO);
     } while (engr_at(tx, ty) || !goodpos(tx, ty, (struct monst *) 0, 0));
 
+    if (isok(ep->engr_x, ep->engr_y)
+        && gl.level.engravings[ep->engr_x][ep->engr_y] == ep)
+        gl.level.engravings[ep->engr_x][ep->engr_y] = (struct engr *) 0;
     ep->engr_x = tx;
     ep->engr_y = ty;
+    gl.level.engravings[tx][ty] = ep;
     newsym(tx, ty);  /* caller took care of the old location */
 }
 
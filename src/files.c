@@ -122,6 +122,9 @@ extern char *sounddir; /* defined in sounds.c */
 
 staticfn NHFILE *new_nhfile(void);
 staticfn void free_nhfile(NHFILE *);
+#ifdef PREGEN_LEVELS
+staticfn const char *set_pregenfile_name(int, boolean);
+#endif
 #ifdef SELECTSAVED
 staticfn int QSORTCALLBACK strcmp_wrap(const void *, const void *);
 #endif
@@ -668,6 +671,13 @@ open_levelfile(int lev, char errbuf[])
 #else
         nhfp->fd = open(fq_lock, O_RDONLY | O_BINARY, 0);
 #endif
+#ifdef FUZZ_SNAPSHOTS
+        /* a fuzz worker that hasn't written this level yet reads the
+           copy belonging to the game it was forked from */
+        if (nhfp->fd < 0 && gp.program_state.fuzz_worker)
+            nhfp->fd = open(fuzz_parent_levelfile(lev), O_RDONLY | O_BINARY,
+                            0);
+#endif
 
         /* for failure, return an explanation that our caller can use;
            settle for `lock' instead of `fq_lock' because the latter
@@ -700,6 +710,9 @@ clearlocks(void)
 {
     int x;
 
+#ifdef PREGEN_LEVELS
+    pregen_cancel(); /* helper's file isn't one of the level files */
+#endif
 #ifdef HANGUPHANDLING
     if (gp.program_state.preserve_locks)
         return;
@@ -715,6 +728,86 @@ clearlocks(void)
         delete_levelfile(x); /* not all levels need be present */
 }
 
+#ifdef PREGEN_LEVELS
+/*
+ * A level made ahead of time by a helper process is written to the
+ * level's file name plus ".pgtmp", then renamed to plus ".pg" once it
+ * is complete.  Neither is treated as one of the game's level files
+ * (by recover, for instance); the game reads the level back in and
+ * deletes the file when the hero arrives.
+ */
+staticfn const char *
+set_pregenfile_name(int lev, boolean partial)
+{
+    static char pgname[2][LOCKNAMESIZE + 10];
+    char *file = pgname[partial ? 1 : 0];
+
+    set_levelfile_name(gl.lock, lev);
+    Snprintf(file, sizeof pgname[0], "%s%s", gl.lock,
+             partial ? ".pgtmp" : ".pg");
+    return fqname(file, LEVELPREFIX, partial ? 1 : 0);
+}
+
+NHFILE *
+create_pregenfile(int lev)
+{
+    const char *fq_pregen = set_pregenfile_name(lev, TRUE);
+    NHFILE *nhfp = new_nhfile();
+
+    if (nhfp) {
+        nhfp->ftype = NHF_LEVELFILE;
+        nhfp->mode = WRITING;
+        nhfp->structlevel = TRUE; /* do set this TRUE for levelfiles */
+        nhfp->fieldlevel = FALSE; /* don't set this TRUE for levelfiles */
+        nhfp->addinfo = FALSE;
+        nhfp->style.deflt = FALSE;
+        nhfp->style.binary = TRUE;
+        nhfp->fpdef = (FILE *) 0;
+        nhfp->fd = creat(fq_pregen, FCMASK);
+    }
+    nhfp = viable_nhfile(nhfp);
+    return nhfp;
+}
+
+/* move completed file to the name the game looks for */
+boolean
+commit_pregenfile(int lev)
+{
+    const char *fq_pregen = set_pregenfile_name(lev, FALSE),
+               *tempname = set_pregenfile_name(lev, TRUE);
+
+    return (rename(tempname, fq_pregen) == 0);
+}
+
+NHFILE *
+open_pregenfile(int lev)
+{
+    const char *fq_pregen = set_pregenfile_name(lev, FALSE);
+    NHFILE *nhfp = new_nhfile();
+
+    if (nhfp) {
+        nhfp->ftype = NHF_LEVELFILE;
+        nhfp->mode = READING;
+        nhfp->structlevel = TRUE; /* do set this TRUE for levelfiles */
+        nhfp->fieldlevel = FALSE; /* do not set this TRUE for levelfiles */
+        nhfp->addinfo = FALSE;
+        nhfp->style.deflt = FALSE;
+        nhfp->style.binary = TRUE;
+        nhfp->fpdef = (FILE *) 0;
+        nhfp->fd = open(fq_pregen, O_RDONLY | O_BINARY, 0);
+    }
+    nhfp = viable_nhfile(nhfp);
+    return nhfp;
+}
+
+void
+delete_pregenfile(int lev)
+{
+    (void) unlink(set_pregenfile_name(lev, TRUE));
+    (void) unlink(set_pregenfile_name(lev, FALSE));
+}
+#endif /* PREGEN_LEVELS */
+
 #if defined(SELECTSAVED)
 /* qsort comparison routine */
 staticfn int QSORTCALLBACK
@@ -923,6 +1016,30 @@ open_bonesfile(d_level *lev, char **bonesid)
     return nhfp;
 }
 
+#ifdef PREGEN_LEVELS
+/* is there a bones file, possibly compressed, for the given level?
+   (contents aren't checked) */
+boolean
+bonesfile_exists(d_level *lev)
+{
+    const char *fq_bones;
+#ifdef COMPRESS_EXTENSION
+    char cfn[FQN_MAX_FILENAME + sizeof COMPRESS_EXTENSION];
+#endif
+
+    (void) set_bonesfile_name(gb.bones, lev);
+    fq_bones = fqname(gb.bones, BONESPREFIX, 0);
+    if (access(fq_bones, F_OK) == 0)
+        return TRUE;
+#ifdef COMPRESS_EXTENSION
+    Snprintf(cfn, sizeof cfn, "%s%s", fq_bones, COMPRESS_EXTENSION);
+    if (access(cfn, F_OK) == 0)
+        return TRUE;
+#endif
+    return FALSE;
+}
+#endif /* PREGEN_LEVELS */
+
 int
 delete_bonesfile(d_level *lev)
 {
@@ -1567,6 +1684,10 @@ docompress_file(const char *filename, boolean uncomp)
      */
     if (istty)
         mark_synch();
+#endif
+#ifdef PREGEN_LEVELS
+    /* wait() below would accept the level helper in place of compressor */
+    pregen_cancel();
 #endif
     f = fork();
     if (f == 0) { /* child */
@@ -1601,6 +1722,7 @@ docompress_file(const char *filename, boolean uncomp)
         (void) fprintf(stderr, "Exec to %scompress %s failed.\n",
                        uncomp ? "un" : "", filename);
         free((genericptr_t) cfn);
+        gl.livelog_qlen = 0; /* the parent's queue, not ours to write */
         nh_terminate(EXIT_FAILURE);
     } else if (f == -1) {
         perror((char *) 0);
@@ -5027,47 +5149,116 @@ Death_quote(char *buf, int bufsz)
 #define LLOG_SEP "\t" /* livelog field separator, as a string literal */
 #define LLOG_EOL "\n" /* end-of-line, for abstraction consistency */
 
-/* Locks the live log file and writes 'buffer'
- * iff the ll_type matches sysopt.livelog mask.
+#ifndef LIVELOG_BATCH
+#define LIVELOG_BATCH 4096 /* flush once this many bytes are queued */
+#endif
+#ifndef LIVELOG_DELAY
+#define LIVELOG_DELAY 30 /* ...or once the oldest record is this old */
+#endif
+
+staticfn void livelog_write(void);
+
+/* Queues a live log entry for 'str' iff the ll_type matches the
+ * sysopt.livelog mask.  Entries are written out in batches by
+ * livelog_flush() rather than one lock/open/close cycle apiece.
  * lltype is included in LL entry for post-process filtering also.
  */
 void
 livelog_add(long ll_type, const char *str)
 {
-    FILE *livelogfile;
+    char buf[BUFSZ + 200];
     time_t now;
-    int gindx, aindx;
+    int gindx, aindx, len;
 
     if (!(ll_type & sysopt.livelog))
         return;
 
+    now = getnow();
+    gindx = flags.female ? 1 : 0;
+    /* note on alignment designation:
+           aligns[] uses [0] lawful, [1] neutral, [2] chaotic;
+           u.ualign.type uses -1 chaotic, 0 neutral, 1 lawful;
+       so subtracting from 1 converts from either to the other */
+    aindx = 1 - u.ualign.type;
+    /* format relies on STD C's implicit concatenation of
+       adjacent string literals */
+    len = snprintf(buf, sizeof buf,
+                   "lltype=%ld"  LLOG_SEP  "name=%s"       LLOG_SEP
+                   "role=%s"     LLOG_SEP  "race=%s"       LLOG_SEP
+                   "gender=%s"   LLOG_SEP  "align=%s"      LLOG_SEP
+                   "turns=%ld"   LLOG_SEP  "starttime=%ld" LLOG_SEP
+                   "curtime=%ld" LLOG_SEP  "message=%s"    LLOG_EOL,
+                   (ll_type & sysopt.livelog), gp.plname,
+                   gu.urole.filecode, gu.urace.filecode,
+                   genders[gindx].filecode, aligns[aindx].filecode,
+                   gm.moves, timet_to_seconds(ubirthday),
+                   timet_to_seconds(now), str);
+    if (len < 0)
+        return;
+    if ((size_t) len >= sizeof buf) {
+        /* overlong message; keep the record intact up to its end */
+        len = (int) sizeof buf - 1;
+        buf[len - 1] = *LLOG_EOL;
+    }
+
+    if (gl.livelog_qlen + len > gl.livelog_qmax) {
+        size_t newmax = gl.livelog_qmax ? gl.livelog_qmax : LIVELOG_BATCH;
+        char *newq;
+
+        while (gl.livelog_qlen + len > newmax)
+            newmax *= 2;
+        newq = (char *) alloc(newmax);
+        if (gl.livelog_qlen)
+            (void) memcpy(newq, gl.livelog_queue, gl.livelog_qlen);
+        if (gl.livelog_queue)
+            free(gl.livelog_queue);
+        gl.livelog_queue = newq;
+        gl.livelog_qmax = newmax;
+    }
+    if (!gl.livelog_qlen)
+        gl.livelog_qtime = now;
+    (void) memcpy(gl.livelog_queue + gl.livelog_qlen, buf, (size_t) len);
+    gl.livelog_qlen += (size_t) len;
+
+    livelog_flush(FALSE);
+}
+
+/* Write out the queued live log entries.  Unless 'force' is set, that
+ * only happens once enough have accumulated or the oldest has been
+ * waiting for LIVELOG_DELAY seconds; this is called every turn, on
+ * level change, and on the way out (save, quit, death, panic).
+ */
+void
+livelog_flush(boolean force)
+{
+    if (!gl.livelog_qlen)
+        return;
+    if (!force && gl.livelog_qlen < LIVELOG_BATCH
+        && getnow() - gl.livelog_qtime < LIVELOG_DELAY)
+        return;
+    livelog_write();
+}
+
+/* lock the live log file and append the whole queue with one write */
+staticfn void
+livelog_write(void)
+{
+    FILE *livelogfile;
+    size_t qlen = gl.livelog_qlen;
+
+    /* empty the queue first; if the file can't be written, the records
+       are dropped rather than retried every turn */
+    gl.livelog_qlen = 0;
     if (lock_file(LIVELOGFILE, SCOREPREFIX, 10)) {
         if (!(livelogfile = fopen_datafile(LIVELOGFILE, "a", SCOREPREFIX))) {
-            pline("Cannot open live log file!");
             unlock_file(LIVELOGFILE);
+            if (!gp.program_state.panicking)
+                pline("Cannot open live log file!");
             return;
         }
-
-        now = getnow();
-        gindx = flags.female ? 1 : 0;
-        /* note on alignment designation:
-               aligns[] uses [0] lawful, [1] neutral, [2] chaotic;
-               u.ualign.type uses -1 chaotic, 0 neutral, 1 lawful;
-           so subtracting from 1 converts from either to the other */
-        aindx = 1 - u.ualign.type;
-        /* format relies on STD C's implicit concatenation of
-           adjacent string literals */
-        (void) fprintf(livelogfile,
-                       "lltype=%ld"  LLOG_SEP  "name=%s"       LLOG_SEP
-                       "role=%s"     LLOG_SEP  "race=%s"       LLOG_SEP
-                       "gender=%s"   LLOG_SEP  "align=%s"      LLOG_SEP
-                       "turns=%ld"   LLOG_SEP  "starttime=%ld" LLOG_SEP
-                       "curtime=%ld" LLOG_SEP  "message=%s"    LLOG_EOL,
-                       (ll_type & sysopt.livelog), gp.plname,
-                       gu.urole.filecode, gu.urace.filecode,
-                       genders[gindx].filecode, aligns[aindx].filecode,
-                       gm.moves, timet_to_seconds(ubirthday),
-                       timet_to_seconds(now), str);
+        /* unbuffered, so that the batch goes out as a single append */
+        (void) setvbuf(livelogfile, (char *) 0, _IONBF, 0);
+        (void) fwrite(gl.livelog_queue, 1, qlen, livelogfile);
         (void) fclose(livelogfile);
         unlock_file(LIVELOGFILE);
     }
@@ -5083,6 +5274,12 @@ livelog_add(long ll_type UNUSED, const char *str UNUSED)
     /* nothing here */
 }
 
+void
+livelog_flush(boolean force UNUSED)
+{
+    /* nothing here */
+}
+
 #endif /* !LIVELOG */
 
 /*files.c*/
@@ -0,0 +1,265 @@
+/* NetHack 3.7	glyphid.c	*/
+/* Copyright (c) Michael Allison, 2021. */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * Construction of the "G_" glyph identifiers used by symset and
+ * config file customizations.
+ *
+ * This isn't compiled on its own.  It is #included by glyphs.c, and
+ * by util/glyphids.c which uses it at build time to produce the
+ * read-only name table and perfect hash in src/glyphtab.c, so the
+ * names in the table are guaranteed to match those the game would
+ * construct for itself.
+ */
+
+#include "hack.h"
+
+#define DUMP_ENUMS
+static const struct enum_dump glyphid_monsnames[] = {
+#include "monsters.h"
+};
+#undef DUMP_ENUMS
+
+#define DUMP_ENUMS_PCHAR
+static const struct enum_dump glyphid_cmapnames[] = {
+#include "defsym.h"
+};
+#undef DUMP_ENUMS_PCHAR
+
+staticfn char *fix_glyphname(char *str);
+staticfn boolean glyphid_name(int glyph, char *outbuf, size_t outsz);
+staticfn uint32 glyphid_hash(const char *id, uint32 seed);
+
+staticfn char *
+fix_glyphname(char *str)
+{
+    char *c;
+
+    for (c = str; *c; c++) {
+        if (*c >= 'A' && *c <= 'Z')
+            *c += (char) ('a' - 'A');
+        else if (*c >= '0' && *c <= '9')
+            ;
+        else if (*c < 'a' || *c > 'z')
+            *c = '_';
+    }
+    return str;
+}
+
+/* put the glyph identifier for 'glyph' into outbuf; returns FALSE for
+   the handful of glyphs that don't get one (unused object slots) */
+staticfn boolean
+glyphid_name(int glyph, char *outbuf, size_t outsz)
+{
+    int i, j, mnum;
+    boolean skip_base = FALSE;
+    const char *buf2 = "", *buf3 = "", *buf4 = "";
+    char buf[2][QBUFSZ];
+
+    outbuf[0] = '\0';
+    buf[0][0] = buf[1][0] = '\0';
+    if (glyph_is_monster(glyph)) {
+        /* buf2 will hold the distinguishing prefix */
+        /* buf3 will hold the base name */
+        buf3 = glyphid_monsnames[glyph_to_mon(glyph)].nm;
+
+        if (glyph_is_normal_male_monster(glyph)) {
+            buf2 = "male_";
+        } else if (glyph_is_normal_female_monster(glyph)) {
+            buf2 = "female_";
+        } else if (glyph_is_ridden_male_monster(glyph)) {
+            buf2 = "ridden_male_";
+        } else if (glyph_is_ridden_female_monster(glyph)) {
+            buf2 = "ridden_female_";
+        } else if (glyph_is_detected_male_monster(glyph)) {
+            buf2 = "detected_male_";
+        } else if (glyph_is_detected_female_monster(glyph)) {
+            buf2 = "detected_female_";
+        } else if (glyph_is_male_pet(glyph)) {
+            buf2 = "pet_male_";
+        } else if (glyph_is_female_pet(glyph)) {
+            buf2 = "pet_female_";
+        }
+    } else if (glyph_is_body(glyph)) {
+        buf3 = glyphid_monsnames[glyph_to_body_corpsenm(glyph)].nm;
+        if (glyph_is_body_piletop(glyph)) {
+            buf2 = "piletop_body_";
+        } else {
+            buf2 = "body_";
+        }
+    } else if (glyph_is_statue(glyph)) {
+        buf3 = glyphid_monsnames[glyph_to_statue_corpsenm(glyph)].nm;
+        if (glyph_is_fem_statue_piletop(glyph)) {
+            buf2 = "piletop_statue_of_female_";
+        } else if (glyph_is_fem_statue(glyph)) {
+            buf2 = "statue_of_female_";
+        } else if (glyph_is_male_statue_piletop(glyph)) {
+            buf2 = "piletop_statue_of_male_";
+        } else if (glyph_is_male_statue(glyph)) {
+            buf2 = "statue_of_male_";
+        }
+    } else if (glyph_is_object(glyph)) {
+        i = glyph_to_obj(glyph);
+        if (((i > SCR_STINKING_CLOUD) && (i < SCR_MAIL))
+            || ((i > WAN_LIGHTNING) && (i < GOLD_PIECE)))
+            return FALSE;
+        if ((i >= WAN_LIGHT) && (i <= WAN_LIGHTNING))
+            buf2 = "wand of ";
+        else if ((i >= SPE_DIG) && (i < SPE_BLANK_PAPER))
+            buf2 = "spellbook of ";
+        else if ((i >= SCR_ENCHANT_ARMOR) && (i <= SCR_STINKING_CLOUD))
+            buf2 = "scroll of ";
+        else if ((i >= POT_GAIN_ABILITY) && (i <= POT_WATER))
+            buf2 = (i == POT_WATER) ? "flask of n" : "potion of ";
+        else if ((i >= RIN_ADORNMENT)
+                 && (i <= RIN_PROTECTION_FROM_SHAPE_CHAN))
+            buf2 = "ring of ";
+        else if (i == LAND_MINE)
+            buf2 = "unset ";
+        buf3 = (i == SCR_BLANK_PAPER) ? "blank scroll"
+               : (i == SPE_BLANK_PAPER) ? "blank spellbook"
+                 : (i == SLIME_MOLD) ? "slime mold"
+                   : obj_descr[i].oc_name ? obj_descr[i].oc_name
+                     : obj_descr[i].oc_descr;
+        if (glyph_is_normal_piletop_obj(glyph)) {
+            Snprintf(buf[0], sizeof buf[0], "piletop_%s", buf2);
+            buf2 = buf[0];
+        }
+    } else if (glyph_is_cmap(glyph) || glyph_is_cmap_zap(glyph)
+               || glyph_is_swallow(glyph) || glyph_is_explosion(glyph)) {
+        int cmap = -1;
+
+        /* buf4 will hold the distinguishing suffix */
+        if (glyph == GLYPH_CMAP_OFF) {
+            cmap = S_stone;
+            buf3 = "stone substrate";
+            skip_base = TRUE;
+        } else if (glyph_is_cmap_gehennom(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_GEH_OFF) + S_vwall;
+            buf4 = "_gehennom";
+        } else if (glyph_is_cmap_knox(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_KNOX_OFF) + S_vwall;
+            buf4 = "_knox";
+        } else if (glyph_is_cmap_main(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_MAIN_OFF) + S_vwall;
+            buf4 = "_main";
+        } else if (glyph_is_cmap_mines(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_MINES_OFF) + S_vwall;
+            buf4 = "_mines";
+        } else if (glyph_is_cmap_sokoban(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_SOKO_OFF) + S_vwall;
+            buf4 = "_sokoban";
+        } else if (glyph_is_cmap_a(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_A_OFF) + S_ndoor;
+        } else if (glyph_is_cmap_altar(glyph)) {
+            static const char *const altar_text[] = {
+                "unaligned", "chaotic", "neutral", "lawful", "other",
+            };
+
+            j = (glyph - GLYPH_ALTAR_OFF);
+            cmap = S_altar;
+            if (j != altar_other) {
+                Snprintf(buf[0], sizeof buf[0], "%s_", altar_text[j]);
+                buf2 = buf[0];
+            } else {
+                buf3 = "altar other";
+                skip_base = TRUE;
+            }
+        } else if (glyph_is_cmap_b(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_B_OFF) + S_grave;
+        } else if (glyph_is_cmap_zap(glyph)) {
+            static const char *const zap_texts[] = {
+                "missile", "fire",      "frost",      "sleep",
+                "death",   "lightning", "poison gas", "acid"
+            };
+
+            j = (glyph - GLYPH_ZAP_OFF);
+            cmap = (j % 4) + S_vbeam;
+            Snprintf(buf[0], sizeof buf[0], "%s",
+                     glyphid_cmapnames[cmap].nm + 2);
+            Snprintf(buf[1], sizeof buf[1], "%s zap %s",
+                     zap_texts[j / 4], fix_glyphname(buf[0]));
+            buf3 = buf[1];
+            skip_base = TRUE;
+        } else if (glyph_is_cmap_c(glyph)) {
+            cmap = (glyph - GLYPH_CMAP_C_OFF) + S_digbeam;
+        } else if (glyph_is_swallow(glyph)) {
+            static const char *const swallow_texts[] = {
+                "top left",      "top center",   "top right",
+                "middle left",   "middle right", "bottom left",
+                "bottom center", "bottom right",
+            };
+
+            j = glyph - GLYPH_SWALLOW_OFF;
+            cmap = glyph_to_swallow(glyph);
+            mnum = j / ((S_sw_br - S_sw_tl) + 1);
+            Snprintf(buf[1], sizeof buf[1], "swallow %s %s",
+                     glyphid_monsnames[mnum].nm, swallow_texts[cmap]);
+            buf3 = buf[1];
+            skip_base = TRUE;
+        } else if (glyph_is_explosion(glyph)) {
+            static const char *const expl_type_texts[] = {
+                "dark",    "noxious", "muddy",  "wet",
+                "magical", "fiery",   "frosty",
+            };
+            static const char *const expl_texts[] = {
+                "tl", "tc", "tr", "ml", "mc", "mr", "bl", "bc", "br",
+            };
+            int expl;
+
+            j = glyph - GLYPH_EXPLODE_OFF;
+            expl = j / ((S_expl_br - S_expl_tl) + 1);
+            cmap = (j % ((S_expl_br - S_expl_tl) + 1)) + S_expl_tl;
+            i = cmap - S_expl_tl;
+            Snprintf(buf[0], sizeof buf[0], "%s ", expl_type_texts[expl]);
+            buf2 = buf[0];
+            Snprintf(buf[1], sizeof buf[1], "expl_%s", expl_texts[i]);
+            buf3 = buf[1];
+            skip_base = TRUE;
+        }
+        if (!skip_base) {
+            if (cmap >= 0 && cmap < MAXPCHARS)
+                buf3 = glyphid_cmapnames[cmap].nm + 2;
+        }
+    } else if (glyph_is_invisible(glyph)) {
+        buf3 = "invisible";
+    } else if (glyph_is_nothing(glyph)) {
+        buf3 = "nothing";
+    } else if (glyph_is_unexplored(glyph)) {
+        buf3 = "unexplored";
+    } else if (glyph_is_warning(glyph)) {
+        j = glyph - GLYPH_WARNING_OFF;
+        Snprintf(buf[1], sizeof buf[1], "warning%d", j);
+        buf3 = buf[1];
+    }
+    Snprintf(outbuf, outsz, "G_%s%s%s", buf2, buf3, buf4);
+    (void) fix_glyphname(outbuf + 2);
+    return TRUE;
+}
+
+/* case-insensitive string hash; different seeds give independent hashes
+   for the two levels of the perfect hash in glyphtab.c */
+staticfn uint32
+glyphid_hash(const char *id, uint32 seed)
+{
+    uint32 hash = 2166136261U ^ (seed * 16777619U);
+
+    for (; *id; ++id) {
+        char ch = *id;
+
+        if ('A' <= ch && ch <= 'Z')
+            ch += 'a' - 'A';
+        hash ^= (uint32) (uchar) ch;
+        hash *= 16777619U;
+    }
+    /* FNV leaves the low bits poorly mixed; fold the high ones in */
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/*glyphid.c*/
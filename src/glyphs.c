@@ -6,11 +6,17 @@
 
 extern const struct symparse loadsyms[];
 extern glyph_map glyphmap[MAX_GLYPH];
-extern struct enum_dump monsdump[];
-extern struct enum_dump objdump[];
 
 #define Fprintf (void) fprintf
 
+#include "glyphid.c"    /* glyphid_name(), glyphid_hash() */
+#ifdef GLYPHID_TABLE
+#include "glyphtab.c"   /* generated by util/glyphids */
+/* the generated table is only usable if it matches the current glyphs;
+   if not, fall back to building the cache at runtime */
+#define glyphid_table_ok (GLYPHID_COUNT == MAX_GLYPH)
+#endif
+
 enum reserved_activities { res_nothing, res_dump_glyphids, res_fill_cache };
 enum things_to_find { find_nothing, find_pm, find_oc, find_cmap, find_glyph };
 struct find_struct {
@@ -39,13 +45,11 @@ static const long nonzero_black = CLR_BLACK | NH_BASIC_COLOR;
 staticfn void init_glyph_cache(void);
 staticfn void add_glyph_to_cache(int glyphnum, const char *id);
 staticfn int find_glyph_in_cache(const char *id);
-staticfn char *find_glyphid_in_cache_by_glyphnum(int glyphnum);
-staticfn uint32 glyph_hash(const char *id);
+staticfn const char *find_glyphid_in_cache_by_glyphnum(int glyphnum);
 staticfn void to_custom_symset_entry_callback(int glyph,
                                             struct find_struct *findwhat);
 staticfn int parse_id(const char *id, struct find_struct *findwhat);
 staticfn int glyph_find_core(const char *id, struct find_struct *findwhat);
-staticfn char *fix_glyphname(char *str);
 staticfn void shuffle_customizations(void);
 /* staticfn void purge_custom_entries(enum graphics_sets which_set); */
 
@@ -150,22 +154,6 @@ glyphrep_to_custom_map_entries(const char *op, int *glyphptr)
     return reslt;
 }
 
-staticfn char *
-fix_glyphname(char *str)
-{
-    char *c;
-
-    for (c = str; *c; c++) {
-        if (*c >= 'A' && *c <= 'Z')
-            *c += (char) ('a' - 'A');
-        else if (*c >= '0' && *c <= '9')
-            ;
-        else if (*c < 'a' || *c > 'z')
-            *c = '_';
-    }
-    return str;
-}
-
 staticfn int
 glyph_find_core(const char *id, struct find_struct *findwhat)
 {
@@ -229,6 +217,10 @@ glyph_find_core(const char *id, struct find_struct *findwhat)
  bulk of the potential parsings. We can later free up
  all the memory those names consumed once the bulk parsing is
  over with.
+
+ With GLYPHID_TABLE, the names and a perfect hash over them are
+ generated at build time into glyphtab.c, so there's nothing
+ to fill or free here.
 */
 
 
@@ -236,6 +228,10 @@ void fill_glyphid_cache(void)
 {
     int reslt = 0;
 
+#ifdef GLYPHID_TABLE
+    if (glyphid_table_ok)
+        return;
+#endif
     if (!glyphid_cache) {
         init_glyph_cache();
     }
@@ -302,7 +298,7 @@ void free_glyphid_cache(void)
 staticfn void
 add_glyph_to_cache(int glyphnum, const char *id)
 {
-    uint32 hash = glyph_hash(id);
+    uint32 hash = glyphid_hash(id, 0);
     size_t hash1 = (size_t) (hash & (glyphid_cache_size - 1));
     size_t hash2 = (size_t)
             (((hash >> glyphid_cache_lsize) & (glyphid_cache_size - 1)) | 1);
@@ -325,12 +321,26 @@ add_glyph_to_cache(int glyphnum, const char *id)
 staticfn int
 find_glyph_in_cache(const char *id)
 {
-    uint32 hash = glyph_hash(id);
-    size_t hash1 = (size_t) (hash & (glyphid_cache_size - 1));
-    size_t hash2 = (size_t)
-            (((hash >> glyphid_cache_lsize) & (glyphid_cache_size - 1)) | 1);
-    size_t i = hash1;
+    uint32 hash;
+    size_t hash1, hash2, i;
+
+#ifdef GLYPHID_TABLE
+    if (glyphid_table_ok) {
+        uint32 d = glyphid_disp[glyphid_hash(id, 0) & (GLYPHID_BUCKETS - 1)];
+        int glyph = glyphid_slot[glyphid_hash(id, d) & (GLYPHID_SLOTS - 1)];
 
+        /* every id in the table has a slot to itself; anything else
+           lands on some other id or on an unused slot */
+        if (glyph >= 0 && strcmpi(id, glyphid_names[glyph]) == 0)
+            return glyph;
+        return -1;
+    }
+#endif
+    hash = glyphid_hash(id, 0);
+    hash1 = (size_t) (hash & (glyphid_cache_size - 1));
+    hash2 = (size_t)
+            (((hash >> glyphid_cache_lsize) & (glyphid_cache_size - 1)) | 1);
+    i = hash1;
     do {
         if (glyphid_cache[i].id == NULL) {
             /* Empty bucket found */
@@ -345,11 +355,15 @@ find_glyph_in_cache(const char *id)
     return -1;
 }
 
-staticfn char *
+staticfn const char *
 find_glyphid_in_cache_by_glyphnum(int glyphnum)
 {
     size_t idx;
 
+#ifdef GLYPHID_TABLE
+    if (glyphid_table_ok)
+        return glyphid_names[glyphnum];
+#endif
     if (!glyphid_cache)
         return (char *) 0;
     for (idx = 0; idx < glyphid_cache_size; ++idx) {
@@ -362,26 +376,13 @@ find_glyphid_in_cache_by_glyphnum(int glyphnum)
     return (char *) 0;
 }
 
-staticfn uint32
-glyph_hash(const char *id)
-{
-    uint32 hash = 0;
-    size_t i;
-
-    for (i = 0; id[i] != '\0'; ++i) {
-        char ch = id[i];
-        if ('A' <= ch && ch <= 'Z') {
-            ch += 'a' - 'A';
-        }
-        hash = (hash << 1) | (hash >> 31);
-        hash ^= ch;
-    }
-    return hash;
-}
-
 boolean
 glyphid_cache_status(void)
 {
+#ifdef GLYPHID_TABLE
+    if (glyphid_table_ok)
+        return TRUE;
+#endif
     return (glyphid_cache != 0);
 }
 
@@ -728,9 +729,9 @@ void
 wizcustom_glyphids(winid win)
 {
     int glyphnum;
-    char *id;
+    const char *id;
 
-    if (!glyphid_cache)
+    if (!glyphid_cache_status())
         return;
     for (glyphnum = 0; glyphnum < MAX_GLYPH; ++glyphnum) {
         id = find_glyphid_in_cache_by_glyphnum(glyphnum);
@@ -744,12 +745,12 @@ staticfn int
 parse_id(const char *id, struct find_struct *findwhat)
 {
     FILE *fp = (FILE *) 0;
-    int i = 0, j, mnum, glyph,
+    int i = 0, glyph,
         pm_offset = 0, oc_offset = 0, cmap_offset = 0,
         pm_count = 0, oc_count = 0, cmap_count = 0;
-    boolean skip_base = FALSE, skip_this_one, dump_ids = FALSE,
-            filling_cache = FALSE, is_S = FALSE, is_G = FALSE;
-    char buf[4][QBUFSZ];
+    boolean dump_ids = FALSE, filling_cache = FALSE,
+            is_S = FALSE, is_G = FALSE;
+    char buf[QBUFSZ];
 
     if (findwhat->findtype == find_nothing && findwhat->restype) {
         if (findwhat->restype == res_dump_glyphids) {
@@ -773,7 +774,7 @@ parse_id(const char *id, struct find_struct *findwhat)
     is_G = (id && id[0] == 'G' && id[1] == '_');
     is_S = (id && id[0] == 'S' && id[1] == '_');
 
-    if ((is_G && !glyphid_cache) || filling_cache || dump_ids || is_S) {
+    if (is_S) {
         while (loadsyms[i].range) {
             if (!pm_offset && loadsyms[i].range == SYM_MON)
                 pm_offset = i;
@@ -791,7 +792,7 @@ parse_id(const char *id, struct find_struct *findwhat)
         }
     }
     if (is_G || filling_cache || dump_ids) {
-        if (!filling_cache && id && glyphid_cache) {
+        if (!filling_cache && id && glyphid_cache_status()) {
             int val = find_glyph_in_cache(id);
             if (val >= 0) {
                 findwhat->findtype = find_glyph;
@@ -802,248 +803,20 @@ parse_id(const char *id, struct find_struct *findwhat)
                 return 0;
             }
         } else {
-            const char *buf2, *buf3, *buf4;
-
             /* individual matching glyph entries */
             for (glyph = 0; glyph < MAX_GLYPH; ++glyph) {
-                skip_base = FALSE;
-                skip_this_one = FALSE;
-                buf[0][0] = buf[1][0] = buf[2][0] = buf[3][0] = '\0';
-                if (glyph_is_monster(glyph)) {
-                    /* buf2 will hold the distinguishing prefix */
-                    /* buf3 will hold the base name */
-                    buf2 = "";
-                    buf3 = monsdump[glyph_to_mon(glyph)].nm;
-
-                    if (glyph_is_normal_male_monster(glyph)) {
-                        buf2 = "male_";
-                    } else if (glyph_is_normal_female_monster(glyph)) {
-                        buf2 = "female_";
-                    } else if (glyph_is_ridden_male_monster(glyph)) {
-                        buf2 = "ridden_male_";
-                    } else if (glyph_is_ridden_female_monster(glyph)) {
-                        buf2 = "ridden_female_";
-                    } else if (glyph_is_detected_male_monster(glyph)) {
-                        buf2 = "detected_male_";
-                    } else if (glyph_is_detected_female_monster(glyph)) {
-                        buf2 = "detected_female_";
-                    } else if (glyph_is_male_pet(glyph)) {
-                        buf2 = "pet_male_";
-                    } else if (glyph_is_female_pet(glyph)) {
-                        buf2 = "pet_female_";
-                    }
-                    Strcpy(buf[0], "G_");
-                    Strcat(buf[0], buf2);
-                    Strcat(buf[0], buf3);
-                } else if (glyph_is_body(glyph)) {
-                    /* buf2 will hold the distinguishing prefix */
-                    /* buf3 will hold the base name */
-                    buf2 = ""; /* superfluous */
-                    buf3 = monsdump[glyph_to_body_corpsenm(glyph)].nm;
-                    if (glyph_is_body_piletop(glyph)) {
-                        buf2 = "piletop_body_";
-                    } else {
-                        buf2 = "body_";
-                    }
-                    Strcpy(buf[0], "G_");
-                    Strcat(buf[0], buf2);
-                    Strcat(buf[0], buf3);
-                } else if (glyph_is_statue(glyph)) {
-                    /* buf2 will hold the distinguishing prefix */
-                    /* buf3 will hold the base name */
-                    buf2 = "";
-                    buf3 = monsdump[glyph_to_statue_corpsenm(glyph)].nm;
-                    if (glyph_is_fem_statue_piletop(glyph)) {
-                        buf2 = "piletop_statue_of_female_";
-                    } else if (glyph_is_fem_statue(glyph)) {
-                        buf2 = "statue_of_female_";
-                    } else if (glyph_is_male_statue_piletop(glyph)) {
-                        buf2 = "piletop_statue_of_male_";
-                    } else if (glyph_is_male_statue(glyph)) {
-                        buf2 = "statue_of_male_";
-                    }
-                    Strcpy(buf[0], "G_");
-                    Strcat(buf[0], buf2);
-                    Strcat(buf[0], buf3);
-                } else if (glyph_is_object(glyph)) {
-                    i = glyph_to_obj(glyph);
-                    /* buf2 will hold the distinguishing prefix */
-                    /* buf3 will hold the base name */
-                    buf2 = "";
-                    buf3 = "";
-                    if (((i > SCR_STINKING_CLOUD) && (i < SCR_MAIL))
-                        || ((i > WAN_LIGHTNING) && (i < GOLD_PIECE)))
-                        skip_this_one = TRUE;
-                    if (!skip_this_one) {
-                        if ((i >= WAN_LIGHT) && (i <= WAN_LIGHTNING))
-                            buf2 = "wand of ";
-                        else if ((i >= SPE_DIG) && (i < SPE_BLANK_PAPER))
-                            buf2 = "spellbook of ";
-                        else if ((i >= SCR_ENCHANT_ARMOR)
-                                 && (i <= SCR_STINKING_CLOUD))
-                            buf2 = "scroll of ";
-                        else if ((i >= POT_GAIN_ABILITY) && (i <= POT_WATER))
-                            buf2 = (i == POT_WATER) ? "flask of n"
-                                                    : "potion of ";
-                        else if ((i >= RIN_ADORNMENT)
-                                 && (i <= RIN_PROTECTION_FROM_SHAPE_CHAN))
-                            buf2 = "ring of ";
-                        else if (i == LAND_MINE)
-                            buf2 = "unset ";
-                        buf3 = (i == SCR_BLANK_PAPER) ? "blank scroll"
-                               : (i == SPE_BLANK_PAPER) ? "blank spellbook"
-                                 : (i == SLIME_MOLD) ? "slime mold"
-                                   : obj_descr[i].oc_name
-                                     ? obj_descr[i].oc_name
-                                     : obj_descr[i].oc_descr;
-                        Strcpy(buf[0], "G_");
-                        if (glyph_is_normal_piletop_obj(glyph))
-                            Strcat(buf[0], "piletop_");
-                        Strcat(buf[0], buf2);
-                        Strcat(buf[0], buf3);
-                    }
-                } else if (glyph_is_cmap(glyph) || glyph_is_cmap_zap(glyph)
-                           || glyph_is_swallow(glyph)
-                           || glyph_is_explosion(glyph)) {
-                    int cmap = -1;
-
-                    /* buf2 will hold the distinguishing prefix */
-                    /* buf3 will hold the base name */
-                    /* buf4 will hold the distinguishing suffix */
-                    buf2 = "";
-                    buf3 = "";
-                    buf4 = "";
-                    if (glyph == GLYPH_CMAP_OFF) {
-                        cmap = S_stone;
-                        buf3 = "stone substrate";
-                        skip_base = TRUE;
-                    } else if (glyph_is_cmap_gehennom(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_GEH_OFF) + S_vwall;
-                        buf4 = "_gehennom";
-                    } else if (glyph_is_cmap_knox(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_KNOX_OFF) + S_vwall;
-                        buf4 = "_knox";
-                    } else if (glyph_is_cmap_main(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_MAIN_OFF) + S_vwall;
-                        buf4 = "_main";
-                    } else if (glyph_is_cmap_mines(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_MINES_OFF) + S_vwall;
-                        buf4 = "_mines";
-                    } else if (glyph_is_cmap_sokoban(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_SOKO_OFF) + S_vwall;
-                        buf4 = "_sokoban";
-                    } else if (glyph_is_cmap_a(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_A_OFF) + S_ndoor;
-                    } else if (glyph_is_cmap_altar(glyph)) {
-                        static const char *const altar_text[] = {
-                            "unaligned", "chaotic", "neutral",
-                            "lawful",    "other",
-                        };
-
-                        j = (glyph - GLYPH_ALTAR_OFF);
-                        cmap = S_altar;
-                        if (j != altar_other) {
-                            Snprintf(buf[2], sizeof buf[2], "%s_",
-                                     altar_text[j]);
-                            buf2 = buf[2];
-                        } else {
-                            buf3 = "altar other";
-                            skip_base = TRUE;
-                        }
-                    } else if (glyph_is_cmap_b(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_B_OFF) + S_grave;
-                    } else if (glyph_is_cmap_zap(glyph)) {
-                        static const char *const zap_texts[] = {
-                            "missile", "fire",      "frost",      "sleep",
-                            "death",   "lightning", "poison gas", "acid"
-                        };
-
-                        j = (glyph - GLYPH_ZAP_OFF);
-                        cmap = (j % 4) + S_vbeam;
-                        Snprintf(buf[2], sizeof buf[2], "%s",
-                                 loadsyms[cmap + cmap_offset].name + 2);
-                        Snprintf(buf[3], sizeof buf[3], "%s zap %s",
-                                 zap_texts[j / 4], fix_glyphname(buf[2]));
-                        buf3 = buf[3];
-                        buf2 = "";
-                        skip_base = TRUE;
-                    } else if (glyph_is_cmap_c(glyph)) {
-                        cmap = (glyph - GLYPH_CMAP_C_OFF) + S_digbeam;
-                    } else if (glyph_is_swallow(glyph)) {
-                        static const char *const swallow_texts[] = {
-                            "top left",      "top center",   "top right",
-                            "middle left",   "middle right", "bottom left",
-                            "bottom center", "bottom right",
-                        };
-
-                        j = glyph - GLYPH_SWALLOW_OFF;
-                        cmap = glyph_to_swallow(glyph);
-                        mnum = j / ((S_sw_br - S_sw_tl) + 1);
-                        i = cmap - S_sw_tl;
-                        Strcpy(buf[3], "swallow ");
-                        Strcat(buf[3], monsdump[mnum].nm);
-                        Strcat(buf[3], " ");
-                        Strcat(buf[3], swallow_texts[cmap]);
-                        buf3 = buf[3];
-                        skip_base = TRUE;
-                    } else if (glyph_is_explosion(glyph)) {
-                        static const char *const expl_type_texts[] = {
-                            "dark",    "noxious", "muddy",  "wet",
-                            "magical", "fiery",   "frosty",
-                        };
-                        static const char *const expl_texts[] = {
-                            "tl", "tc", "tr", "ml", "mc",
-                            "mr", "bl", "bc", "br",
-                        };
-                        int expl;
-
-                        j = glyph - GLYPH_EXPLODE_OFF;
-                        expl = j / ((S_expl_br - S_expl_tl) + 1);
-                        cmap = (j % ((S_expl_br - S_expl_tl) + 1))
-                               + S_expl_tl;
-                        i = cmap - S_expl_tl;
-                        Snprintf(buf[2], sizeof buf[2], "%s ",
-                                 expl_type_texts[expl]);
-                        buf2 = buf[2];
-                        Snprintf(buf[3], sizeof buf[3], "%s%s", "expl_",
-                                 expl_texts[i]);
-                        buf3 = buf[3];
-                        skip_base = TRUE;
-                    }
-                    if (!skip_base) {
-                        if (cmap >= 0 && cmap < MAXPCHARS) {
-                            buf3 = loadsyms[cmap + cmap_offset].name + 2;
-                        }
-                    }
-                    Strcpy(buf[0], "G_");
-                    Strcat(buf[0], buf2);
-                    Strcat(buf[0], buf3);
-                    Strcat(buf[0], buf4);
-                } else if (glyph_is_invisible(glyph)) {
-                    Strcpy(buf[0], "G_invisible");
-                } else if (glyph_is_nothing(glyph)) {
-                    Strcpy(buf[0], "G_nothing");
-                } else if (glyph_is_unexplored(glyph)) {
-                    Strcpy(buf[0], "G_unexplored");
-                } else if (glyph_is_warning(glyph)) {
-                    j = glyph - GLYPH_WARNING_OFF;
-                    Snprintf(buf[0], sizeof buf[0], "G_%s%d", "warning", j);
-                }
-                if (memchr(buf[0], '\0', sizeof buf[0]) == NULL)
-                    panic("parse_id: buf[0] overflowed");
-                if (!skip_this_one) {
-                    fix_glyphname(buf[0]+2);
-                    if (dump_ids) {
-                        Fprintf(fp, "(%04d) %s\n", glyph, buf[0]);
-                    } else if (filling_cache) {
-                        add_glyph_to_cache(glyph, buf[0]);
-                    } else if (id) {
-                        if (!strcmpi(id, buf[0])) {
-                            findwhat->findtype = find_glyph;
-                            findwhat->val = glyph;
-                            findwhat->loadsyms_offset = 0;
-                            return 1;
-                        }
+                if (!glyphid_name(glyph, buf, sizeof buf))
+                    continue;
+                if (dump_ids) {
+                    Fprintf(fp, "(%04d) %s\n", glyph, buf);
+                } else if (filling_cache) {
+                    add_glyph_to_cache(glyph, buf);
+                } else if (id) {
+                    if (!strcmpi(id, buf)) {
+                        findwhat->findtype = find_glyph;
+                        findwhat->val = glyph;
+                        findwhat->loadsyms_offset = 0;
+                        return 1;
                     }
                 }
             }
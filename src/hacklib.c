@@ -53,6 +53,9 @@
         boolean         fuzzymatch      (const char *, const char *,
                                          const char *, boolean)
         int             swapbits        (int, int, int)
+        uint64          hash_bytes      (uint64, const genericptr_t,
+                                         size_t)
+        boolean         regex_literal   (const char *, char *, size_t)
         void            nh_snprintf     (const char *, int, char *, size_t,
                                          const char *, ...)
 =*/
@@ -836,6 +839,106 @@ swapbits(int val, int bita, int bitb)
     return (val ^ ((tmp << bita) | (tmp << bitb)));
 }
 
+/* 64-bit FNV-1a hash of 'len' bytes at 'buf', continuing from 'h';
+   pass 0 for 'h' to start a new hash */
+uint64
+hash_bytes(uint64 h, const genericptr_t buf, size_t len)
+{
+    const unsigned char *p = (const unsigned char *) buf;
+
+    if (!h)
+        h = 0xcbf29ce484222325ULL; /* FNV offset basis */
+    while (len-- > 0) {
+        h ^= (uint64) *p++;
+        h *= 0x100000001b3ULL; /* FNV prime */
+    }
+    return h;
+}
+
+/* put into outbuf[] the longest run of plain text which anything that
+   matches POSIX extended regular expression 'pat' has to contain, so
+   that a regex implementation can rule out most strings with strstr();
+   returns True if 'pat' consists of nothing but that text */
+boolean
+regex_literal(const char *pat, char *outbuf, size_t outsz)
+{
+    char run[BUFSZ], c;
+    const char *p;
+    size_t runlen = 0, bestlen = 0;
+    int depth = 0;
+    boolean plain = TRUE;
+
+    outbuf[0] = '\0';
+    if (outsz > sizeof run)
+        outsz = sizeof run;
+    for (p = pat; ; ++p) {
+        c = *p;
+        if (c == '\\' && p[1] && strchr("\\.^$+*?{}[]()|", p[1])) {
+            c = *++p; /* escaped special character stands for itself */
+        } else if (c && !strchr("\\.^$+*?{[()|", c)) {
+            ; /* ordinary character */
+        } else {
+            if (c)
+                plain = FALSE;
+            /* a quantifier which allows zero repetitions makes the
+               preceding character optional */
+            if ((c == '*' || c == '?' || c == '{') && runlen > 0)
+                --runlen;
+            if (runlen > bestlen) {
+                bestlen = runlen;
+                (void) memcpy((genericptr_t) outbuf, (genericptr_t) run,
+                              bestlen);
+                outbuf[bestlen] = '\0';
+            }
+            runlen = 0;
+            if (!c)
+                break;
+            if (c == '|' && depth == 0) {
+                /* alternatives at top level; no text is required */
+                outbuf[0] = '\0';
+                return FALSE;
+            } else if (c == '{') {
+                while (p[1] && p[1] != '}')
+                    ++p;
+            } else if (c == '[') {
+                /* skip bracket expression; a leading ']' is literal */
+                if (p[1] == '^')
+                    ++p;
+                if (p[1] == ']')
+                    ++p;
+                while (p[1] && p[1] != ']') {
+                    ++p;
+                    if (*p == '[' && p[1] && strchr(":.=", p[1])) {
+                        char delim = p[1];
+
+                        for (p += 2; *p && (*p != delim || p[1] != ']'); ++p)
+                            continue;
+                        if (!*p)
+                            return FALSE; /* malformed */
+                        ++p;
+                    }
+                }
+            } else if (c == '(') {
+                ++depth;
+            } else if (c == ')') {
+                --depth;
+            }
+            /* any other escape might be an anchor ("\<", "\b", "\`")
+               or a character class ("\w"); either way it ends the run */
+            if (*p && p[1] && (c == '\\' || c == '[' || c == '{'))
+                ++p; /* skip escaped character, closing ']' or '}' */
+            continue;
+        }
+        /* text within a group might be optional or repeated */
+        if (depth > 0 || runlen + 1 >= outsz) {
+            plain = FALSE;
+            continue;
+        }
+        run[runlen++] = c;
+    }
+    return (plain && bestlen > 0);
+}
+
 DISABLE_WARNING_FORMAT_NONLITERAL
 
 /*
@@ -2483,7 +2483,7 @@ int
 do_gamelog(void)
 {
 #ifdef CHRONICLE
-    if (gg.gamelog) {
+    if (gg.gamelog_cnt) {
         show_gamelog(ENL_GAMEINPROGRESS);
     } else {
         pline("No chronicled events.");
@@ -2516,18 +2516,20 @@ show_gamelog(int final)
     winid win;
     char buf[BUFSZ];
     int eventcnt = 0;
+    unsigned i;
 
     win = create_nhwindow(NHW_TEXT);
     Sprintf(buf, "%s events:", final ? "Major" : "Logged");
     putstr(win, 0, buf);
-    for (llmsg = gg.gamelog; llmsg; llmsg = llmsg->next) {
+    for (i = 0; i < gg.gamelog_cnt; ++i) {
+        llmsg = &gg.gamelog[i];
         if (final && !majorevent(llmsg))
             continue;
         if (!final && !wizard && spoilerevent(llmsg))
             continue;
         if (!eventcnt++)
             putstr(win, 0, " Turn");
-        Sprintf(buf, "%5ld: %s", llmsg->turn, llmsg->text);
+        Sprintf(buf, "%5ld: %s", llmsg->turn, gamelog_msg(llmsg));
         putstr(win, 0, buf);
     }
     /* since start of game is logged as a major event, 'eventcnt' should
@@ -1106,6 +1106,7 @@ addinv_core0(struct obj *obj, struct obj *other_obj,
         obj->nobj = 0;
     }
     obj->where = OBJ_INVENT;
+    minvent_changed(&gy.youmonst);
 
     /* fill empty quiver if obj was thrown */
     if (obj_was_thrown && flags.pickup_thrown && !uquiver
@@ -1122,6 +1123,7 @@ addinv_core0(struct obj *obj, struct obj *other_obj,
         setuqwep(obj);
  added:
     obj->pickup_prev = 1;
+    sanity_touch_obj(obj);
     addinv_core2(obj); /* handle extrinsics conferred by carrying obj */
     carry_obj_effects(obj); /* carrying affects the obj */
     if (update_perm_invent)
@@ -1373,6 +1375,7 @@ void
 freeinv(struct obj *obj)
 {
     extract_nobj(obj, &gi.invent);
+    minvent_changed(&gy.youmonst);
     obj->pickup_prev = 0;
     freeinv_core(obj);
     update_inventory();
@@ -1464,13 +1467,7 @@ nxtobj(struct obj *obj, int type, boolean by_nexthere)
 struct obj *
 carrying(int type)
 {
-    struct obj *otmp;
-
-    /* this could be replaced by 'return m_carrying(&gy.youmonst, type);' */
-    for (otmp = gi.invent; otmp; otmp = otmp->nobj)
-        if (otmp->otyp == type)
-            break;
-    return otmp;
+    return m_carrying(&gy.youmonst, type);
 }
 
 /* Fictional and not-so-fictional currencies.
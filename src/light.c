@@ -368,9 +368,15 @@ struct monst *
 find_mid(unsigned nid, unsigned fmflags)
 {
     struct monst *mtmp;
+    anything *idp;
 
     if (!nid)
         return &gy.youmonst;
+    /* when a caller is doing many lookups, use the index they set up */
+    if (gi.id_index_depth && fmflags == FM_EVERYWHERE) {
+        idp = id_index_find(&gi.mid_index, nid);
+        return idp ? idp->a_monst : (struct monst *) 0;
+    }
     if (fmflags & FM_FMON)
         for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
             if (!DEADMONSTER(mtmp) && mtmp->m_id == nid)
@@ -405,7 +411,9 @@ save_light_sources(NHFILE *nhfp, int range)
         if (nhfp->structlevel) {
             bwrite(nhfp->fd, (genericptr_t) &count, sizeof count);
         }
+        id_index_begin(); /* for write_ls()'s find_oid() and find_mid() */
         actual = maybe_write_ls(nhfp, range, TRUE);
+        id_index_end();
         if (actual != count)
             panic("counted %d light sources, wrote %d! [range=%d]", count,
                   actual, range);
@@ -490,6 +498,7 @@ relink_light_sources(boolean ghostly)
     unsigned nid;
     light_source *ls;
 
+    id_index_begin();
     for (ls = gl.light_base; ls; ls = ls->next) {
         if (ls->flags & LSF_NEEDS_FIXUP) {
             if (ls->type == LS_OBJECT || ls->type == LS_MONSTER) {
@@ -522,6 +531,7 @@ relink_light_sources(boolean ghostly)
             ls->flags &= ~LSF_NEEDS_FIXUP;
         }
     }
+    id_index_end();
 }
 
 /*
@@ -572,6 +582,7 @@ light_sources_sanity_check(void)
     struct obj *otmp;
     unsigned int auint;
 
+    id_index_begin();
     for (ls = gl.light_base; ls; ls = ls->next) {
         if (!ls->id.a_monst)
             panic("insane light source: no id!");
@@ -589,6 +600,7 @@ light_sources_sanity_check(void)
             panic("insane light source: bad ls type %d", ls->type);
         }
     }
+    id_index_end();
 }
 
 /* Write a light source structure to disk. */
@@ -861,6 +861,7 @@ clone_mon(struct monst *mon,
     m2->mtrapped = 0;
     m2->mcloned = 1;
     m2->minvent = (struct obj *) 0; /* objects don't clone */
+    minvent_changed(m2);
     m2->mleashed = 0;
     /* Max HP the same, but current HP halved for both.  The caller
      * might want to override this by halving the max HP also.
@@ -1052,7 +1053,7 @@ newmextra(void)
 {
     struct mextra *mextra;
 
-    mextra = (struct mextra *) alloc(sizeof (struct mextra));
+    mextra = (struct mextra *) nhpool_get(&mextra_pool);
     init_mextra(mextra);
     return mextra;
 }
@@ -1063,39 +1064,47 @@ makemon_rnd_goodpos(
     mmflags_nht gpflags,
     coord *cc) /* output */
 {
-    int tryct = 0;
-    coordxy nx, ny;
-    boolean good;
+    int tryct = 0, lastkind, i, n, ofs;
+    coordxy nx = 0, ny = 0;
+    coord fc;
+    boolean good = FALSE;
 
     gpflags |= GP_AVOID_MONPOS;
-    do {
-        nx = rn1(COLNO - 3, 2);
-        ny = rn2(ROWNO);
+    /* random probes are drawn from the unoccupied spots whose terrain
+       'mon' could conceivably use rather than from the whole map */
+    lastkind = freecell_kinds(mon, gpflags);
+    /* terrain changes wholesale during level creation */
+    if (gi.in_mklev)
+        (void) freecell_count(lastkind, TRUE);
+    while (tryct++ < 50 && freecell_random(lastkind, &fc)) {
+        nx = fc.x, ny = fc.y;
         good = (!gi.in_mklev && cansee(nx,ny)) ? FALSE
                                               : goodpos(nx, ny, mon, gpflags);
-    } while ((++tryct < 50) && !good);
+        if (good)
+            break;
+    }
 
     if (!good) {
-        /* else go through all map positions, twice, first round
-           ignoring positions in sight, and pick first good one.
+        /* else go through all the candidate positions, twice, first
+           round ignoring positions in sight, and pick first good one.
            skip first round if we're in special level loader or blind */
-        coordxy xofs = nx;
-        coordxy yofs = ny;
-        coordxy dx,dy;
         int bl = (gi.in_mklev || Blind) ? 1 : 0;
 
+        /* this is the exhaustive search, so make sure that the index
+           reflects current terrain; nothing outside it can qualify */
+        n = freecell_count(lastkind, TRUE);
+        ofs = n ? rn2(n) : 0;
         for ( ; bl < 2; bl++) {
             if (!bl)
                 gpflags &= ~GP_CHECKSCARY; /* perhaps should be a 3rd pass */
-            for (dx = 0; dx < COLNO; dx++)
-                for (dy = 0; dy < ROWNO; dy++) {
-                    nx = ((dx + xofs) % (COLNO - 1)) + 1;
-                    ny = ((dy + yofs) % (ROWNO - 1)) + 1;
-                    if (bl == 0 && cansee(nx,ny))
-                        continue;
-                    if (goodpos(nx, ny, mon, gpflags))
-                        goto gotgood;
-                }
+            for (i = 0; i < n; i++) {
+                freecell_nth((i + ofs) % n, &fc);
+                nx = fc.x, ny = fc.y;
+                if (bl == 0 && cansee(nx,ny))
+                    continue;
+                if (goodpos(nx, ny, mon, gpflags))
+                    goto gotgood;
+            }
             if (bl == 0 && (!mon || mon->data->mmove)) {
                 stairway *stway = gs.stairs;
                 /* all map positions are visible (or not good),
@@ -43,6 +43,12 @@ staticfn void do_room_or_subroom(struct mkroom *,
 staticfn void makerooms(void);
 staticfn boolean door_into_nonjoined(coordxy, coordxy);
 staticfn boolean finddpos(coord *, coordxy, coordxy, coordxy, coordxy);
+#ifdef PREGEN_LEVELS
+staticfn uint64 pregen_inputs(void);
+staticfn uint64 pregen_fixed_state(void);
+staticfn boolean pregen_candidate(d_level *) NONNULLARG1;
+staticfn void pregen_child(d_level *) NONNULLARG1;
+#endif
 
 #define create_vault() create_room(-1, -1, 2, 2, -1, -1, VAULT, TRUE)
 #define init_vault() gv.vault_x = -1
@@ -771,6 +777,9 @@ clear_level_structures(void)
             *lev++ = zerorm;
             gl.level.objects[x][y] = (struct obj *) 0;
             gl.level.monsters[x][y] = (struct monst *) 0;
+            gl.level.traps[x][y] = (struct trap *) 0;
+            gl.level.engravings[x][y] = (struct engr *) 0;
+            gl.level.stairways[x][y] = (stairway *) 0;
         }
     }
     gl.level.objlist = (struct obj *) 0;
@@ -1390,18 +1399,345 @@ mklev(void)
     reseed_random(rn2);
     reseed_random(rn2_on_display_rng);
 
+    PROF_START(PROF_MKLEV);
     init_mapseen(&u.uz);
-    if (getbones())
+    if (getbones()) {
+        PROF_STOP(PROF_MKLEV);
         return;
+    }
 
     gi.in_mklev = TRUE;
     makelevel();
 
     level_finalize_topology();
+    /* the free cell index was describing the level under construction */
+    freecell_reset();
+
+    reseed_random(rn2);
+    reseed_random(rn2_on_display_rng);
+    PROF_STOP(PROF_MKLEV);
+}
+
+#ifdef PREGEN_LEVELS
+/*
+ * Making the level below ahead of time.
+ *
+ * While the hero stands on a down staircase with no command pending,
+ * a helper process is forked to make the level the stairs lead to.
+ * It tears down its copy of the current level the way goto_level()
+ * would, runs the same steps as mklev(), and writes the result along
+ * with everything that level creation changes outside of the level
+ * (next object/monster id, next timer id, monster birth counts,
+ * artifact existence, the core random number generator) to a file.
+ * If the hero then takes the stairs, goto_level() picks that file up
+ * instead of calling mklev().
+ *
+ * The result is only used if a checksum of the state that level
+ * creation reads matches the one the helper started from, so a hero
+ * who does something else first--or a helper which hasn't finished
+ * or failed--just falls back to making the level normally.  The game
+ * plays out identically with or without the option; only ordinary
+ * room-and-corridor and maze filler levels qualify, and a level that
+ * might receive bones is always left for mklev().
+ */
+
+struct pregen_hdr {
+    uint64 inputs;         /* pregen_inputs() before the level was made */
+    unsigned ident;        /* gc.context.ident afterward */
+    unsigned long timer_id;
+    struct obj_split objsplit;
+    boolean made_amulet, made_fruit;
+};
+
+static struct pregen_state {
+    int pid;       /* helper process, 0 if none */
+    xint16 ledger; /* level it is making */
+    long moves;    /* turn it was started on */
+} pregen = { 0, 0, 0L };
+
+/* checksum of the state that making a level depends on; the helper
+   computes it after setting up for the new level and goto_level()
+   computes it just before the point where it would call mklev() */
+staticfn uint64
+pregen_inputs(void)
+{
+    branch *br;
+    uint64 h = 0;
+    xint16 lev = ledger_no(&u.uz);
+
+    h = hash_bytes(h, (genericptr_t) &u, sizeof u);
+    h = hash_bytes(h, (genericptr_t) &flags, sizeof flags);
+    h = hash_bytes(h, (genericptr_t) &gm.moves, sizeof gm.moves);
+    h = hash_bytes(h, (genericptr_t) &gc.context.ident,
+                   sizeof gc.context.ident);
+    h = hash_bytes(h, (genericptr_t) &gc.context.current_fruit,
+                   sizeof gc.context.current_fruit);
+    h = hash_bytes(h, (genericptr_t) &gc.context.made_amulet,
+                   sizeof gc.context.made_amulet);
+    h = hash_bytes(h, (genericptr_t) &gt.timer_id, sizeof gt.timer_id);
+    h = hash_bytes(h, (genericptr_t) gm.mvitals, sizeof gm.mvitals);
+    h = artifact_hash(h);
+    h = hash_bytes(h, (genericptr_t) objects, sizeof objects);
+    h = hash_bytes(h, (genericptr_t) gd.dungeons,
+                   (size_t) gn.n_dgns * sizeof (dungeon));
+    for (br = gb.branches; br; br = br->next)
+        h = hash_bytes(h, (genericptr_t) br, sizeof *br);
+    h = hash_bytes(h, (genericptr_t) &gl.level_info[lev],
+                   sizeof gl.level_info[lev]);
+    if (!has_strong_rngseed) {
+        /* otherwise mklev() reseeds and the old state doesn't matter */
+        size_t rngsize = core_rng_state_size();
+        genericptr_t rngbuf = (genericptr_t) alloc(rngsize);
+
+        get_core_rng_state(rngbuf);
+        h = hash_bytes(h, rngbuf, rngsize);
+        free(rngbuf);
+    }
+    return h;
+}
+
+/* checksum of state that level creation shouldn't modify; if it does,
+   the helper's result can't be handed back to the game */
+staticfn uint64
+pregen_fixed_state(void)
+{
+    struct you youcopy;
+    struct flag flagcopy;
+    struct context_info contextcopy;
+    branch *br;
+    uint64 h = 0;
+
+    /* the fields handed back are excluded */
+    (void) memcpy((genericptr_t) &youcopy, (genericptr_t) &u, sizeof u);
+    (void) memcpy((genericptr_t) &flagcopy, (genericptr_t) &flags,
+                  sizeof flags);
+    flagcopy.made_fruit = FALSE;
+    (void) memcpy((genericptr_t) &contextcopy, (genericptr_t) &gc.context,
+                  sizeof gc.context);
+    contextcopy.ident = 0;
+    contextcopy.made_amulet = FALSE;
+    (void) memset((genericptr_t) &contextcopy.objsplit, 0,
+                  sizeof contextcopy.objsplit);
+
+    h = hash_bytes(h, (genericptr_t) &youcopy, sizeof youcopy);
+    h = hash_bytes(h, (genericptr_t) &flagcopy, sizeof flagcopy);
+    h = hash_bytes(h, (genericptr_t) &contextcopy, sizeof contextcopy);
+    h = hash_bytes(h, (genericptr_t) gd.dungeons,
+                   (size_t) gn.n_dgns * sizeof (dungeon));
+    for (br = gb.branches; br; br = br->next)
+        h = hash_bytes(h, (genericptr_t) br, sizeof *br);
+    h = hash_bytes(h, (genericptr_t) gl.level_info,
+                   (size_t) (maxledgerno() + 1) * sizeof (struct linfo));
+    h = hash_bytes(h, (genericptr_t) &gi.inv_pos, sizeof gi.inv_pos);
+    h = hash_bytes(h, (genericptr_t) &gm.migrating_objs,
+                   sizeof gm.migrating_objs);
+    h = hash_bytes(h, (genericptr_t) &gm.migrating_mons,
+                   sizeof gm.migrating_mons);
+    h = hash_bytes(h, (genericptr_t) &gf.ffruit, sizeof gf.ffruit);
+    return h;
+}
+
+/* is the hero on stairs leading to a level the helper could make? */
+staticfn boolean
+pregen_candidate(d_level *dest)
+{
+    stairway *stway = stairway_at(u.ux, u.uy);
+    xint16 lev;
+
+    if (!stway || stway->up || stway->tolev.dnum != u.uz.dnum
+        || u.ustuck || u.utrap || In_endgame(&u.uz))
+        return FALSE;
+    assign_level(dest, &stway->tolev);
+    lev = ledger_no(dest);
+    if ((gl.level_info[lev].flags & (LFILE_EXISTS | VISITED)) != 0)
+        return FALSE;
+    /* special levels and the per-dungeon fillers are made by level
+       scripts which can set state this doesn't know to hand back */
+    if (Is_special(dest) || gd.dungeons[dest->dnum].proto[0]
+        || gd.dungeons[dest->dnum].fill_lvl[0]
+        || In_quest(dest) || In_hell(dest))
+        return FALSE;
+    return !bonesfile_exists(dest);
+}
+
+/* runs in the helper; never returns */
+staticfn void
+pregen_child(d_level *dest)
+{
+    NHFILE tnhfp, *nhfp;
+    struct pregen_hdr hdr;
+    genericptr_t rngbuf;
+    size_t rngsize;
+    uint64 unchanged;
+    xint16 lev = ledger_no(dest);
+
+    gp.program_state.pregen_helper = 1;
+    /* nothing the helper does should reach the screen or keyboard */
+    nhwindows_hangup();
+    (void) signal(SIGINT, SIG_IGN);
+    (void) signal(SIGQUIT, SIG_IGN);
+    (void) signal(SIGHUP, SIG_IGN);
+
+    /* let go of the current level and arrive on the new one, as far as
+       goto_level() gets before calling mklev() */
+    check_special_room(TRUE);
+    reset_utrap(FALSE);
+    set_uinwater(0);
+    u.uundetected = 0;
+    zero_nhfile(&tnhfp);
+    tnhfp.mode = FREEING;
+    savelev(&tnhfp, ledger_no(&u.uz));
+    assign_level(&u.uz0, &u.uz);
+    assign_level(&u.uz, dest);
+    assign_level(&u.utolev, dest);
+    u.utotype = UTOTYPE_NONE;
+    record_dunlev_reached();
+    stairway_free_all();
+    (void) memset((genericptr_t) &gu.updest, 0, sizeof gu.updest);
+    (void) memset((genericptr_t) &gd.dndest, 0, sizeof gd.dndest);
+
+    (void) memset((genericptr_t) &hdr, 0, sizeof hdr);
+    hdr.inputs = pregen_inputs();
+    unchanged = pregen_fixed_state();
 
+    /* mklev(), except that a level which might get bones is abandoned
+       rather than taking the bones file away from whoever finds it */
     reseed_random(rn2);
     reseed_random(rn2_on_display_rng);
+    init_mapseen(&u.uz);
+    if (bones_possible() && bonesfile_exists(&u.uz))
+        _exit(EXIT_FAILURE);
+    gi.in_mklev = TRUE;
+    makelevel();
+    level_finalize_topology();
+    reseed_random(rn2);
+    reseed_random(rn2_on_display_rng);
+    if (pregen_fixed_state() != unchanged)
+        _exit(EXIT_FAILURE);
+
+    hdr.ident = gc.context.ident;
+    hdr.timer_id = gt.timer_id;
+    hdr.objsplit = gc.context.objsplit;
+    hdr.made_amulet = gc.context.made_amulet;
+    hdr.made_fruit = flags.made_fruit;
+
+    if (!(nhfp = create_pregenfile(lev)))
+        _exit(EXIT_FAILURE);
+    bufon(nhfp->fd);
+    bwrite(nhfp->fd, (genericptr_t) &hdr, sizeof hdr);
+    rngsize = core_rng_state_size();
+    rngbuf = (genericptr_t) alloc(rngsize);
+    get_core_rng_state(rngbuf);
+    bwrite(nhfp->fd, rngbuf, (unsigned) rngsize);
+    free(rngbuf);
+    bwrite(nhfp->fd, (genericptr_t) gm.mvitals, sizeof gm.mvitals);
+    save_artifacts(nhfp);
+    savelev(nhfp, lev);
+    close_nhfile(nhfp);
+    _exit(commit_pregenfile(lev) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* called at the start of each command; start, keep, or stop a helper */
+void
+pregen_level_check(void)
+{
+    d_level dest;
+    xint16 lev;
+    int pid;
+
+    if (!iflags.pregen_levels || !pregen_candidate(&dest)) {
+        pregen_cancel();
+        return;
+    }
+    lev = ledger_no(&dest);
+    if (pregen.pid && pregen.ledger == lev && pregen.moves == gm.moves)
+        return; /* already at it */
+
+    /* a helper from an earlier turn is working from stale state */
+    pregen_cancel();
+    pid = fork();
+    if (pid == 0)
+        pregen_child(&dest); /* doesn't return */
+    if (pid > 0) {
+        pregen.pid = pid;
+        pregen.ledger = lev;
+        pregen.moves = gm.moves;
+    }
+}
+
+/* called by goto_level() in place of mklev(); returns TRUE if the level
+   made by the helper has been loaded */
+boolean
+pregen_load_level(xint16 lev)
+{
+    NHFILE *nhfp;
+    struct pregen_hdr hdr;
+    genericptr_t rngbuf;
+    size_t rngsize;
+    int status = 0;
+
+    if (!pregen.pid || pregen.ledger != lev || pregen.moves != gm.moves) {
+        pregen_cancel();
+        return FALSE;
+    }
+    /* usually it finished while the player was deciding what to do */
+    if (waitpid(pregen.pid, &status, 0) != pregen.pid
+        || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        pregen.pid = 0;
+        delete_pregenfile(lev);
+        return FALSE;
+    }
+    pregen.pid = 0;
+    if (bonesfile_exists(&u.uz) /* appeared after the helper checked */
+        || !(nhfp = open_pregenfile(lev))) {
+        delete_pregenfile(lev);
+        return FALSE;
+    }
+    mread(nhfp->fd, (genericptr_t) &hdr, sizeof hdr);
+    if (hdr.inputs != pregen_inputs()) {
+        close_nhfile(nhfp);
+        delete_pregenfile(lev);
+        return FALSE;
+    }
+
+    /* the same steps as mklev(), with the helper's results */
+    init_mapseen(&u.uz);
+    rngsize = core_rng_state_size();
+    rngbuf = (genericptr_t) alloc(rngsize);
+    mread(nhfp->fd, rngbuf, (unsigned) rngsize);
+    set_core_rng_state(rngbuf);
+    free(rngbuf);
+    reseed_random(rn2_on_display_rng);
+    mread(nhfp->fd, (genericptr_t) gm.mvitals, sizeof gm.mvitals);
+    restore_artifacts(nhfp);
+    gc.context.ident = hdr.ident;
+    gt.timer_id = hdr.timer_id;
+    gc.context.objsplit = hdr.objsplit;
+    gc.context.made_amulet = hdr.made_amulet;
+    flags.made_fruit = hdr.made_fruit;
+    minit(); /* ZEROCOMP */
+    getlev(nhfp, gh.hackpid, lev);
+    close_nhfile(nhfp);
+    delete_pregenfile(lev);
+    oinit(); /* level dependent obj probabilities, as makelevel() set */
+    gx.xstart = gy.ystart = 0;
+    return TRUE;
+}
+
+/* stop the helper, if any, and discard its work */
+void
+pregen_cancel(void)
+{
+    int status;
+
+    if (!pregen.pid)
+        return;
+    (void) kill(pregen.pid, SIGKILL);
+    (void) waitpid(pregen.pid, &status, 0);
+    delete_pregenfile(pregen.ledger);
+    pregen.pid = 0;
 }
+#endif /* PREGEN_LEVELS */
 
 void
 #ifdef SPECIALIZATION
@@ -8,9 +8,32 @@
 #define HEIGHT (ROWNO - 1)
 #define WIDTH (COLNO - 2)
 
+/*
+ * The cellular automaton passes work on a bit-plane copy of the map:
+ * one word per column, with bit j set when levl[col][j].typ is fg_typ.
+ * Everything outside the area being generated (column 0, the rightmost
+ * column, and the bottom row) counts as background and is a zero bit,
+ * so the neighbour counts for a whole column come from eight passes
+ * through a bitwise adder rather than eight bounds-checked lookups for
+ * each location.  Results are the same as counting one at a time.
+ */
+typedef uint32 mapcol;
+#if ROWNO > 32
+#error mkmap.c: a mapcol must hold a full column of the map
+#endif
+#define MAPCOL_ROWS ((((mapcol) 1) << HEIGHT) - 2) /* rows 1..HEIGHT-1 */
+
+/* neighbour counts for each row of a column, as four bit-planes */
+struct nbcount {
+    mapcol b0, b1, b2, b3;
+};
+
 staticfn void init_map(schar);
 staticfn void init_fill(schar, schar);
-staticfn schar get_map(int, int, schar);
+staticfn void fill_planes(mapcol *, schar);
+staticfn void count_add(struct nbcount *, mapcol);
+staticfn void count_neighbours(struct nbcount *, mapcol, mapcol, mapcol);
+staticfn void set_bg_rows(int, mapcol, schar);
 staticfn void pass_one(schar, schar);
 staticfn void pass_two(schar, schar);
 staticfn void pass_three(schar, schar);
@@ -51,96 +74,130 @@ init_fill(schar bg_typ, schar fg_typ)
     }
 }
 
-staticfn schar
-get_map(int col, int row, schar bg_typ)
+staticfn void
+fill_planes(mapcol *plane, schar fg_typ)
 {
-    if (col <= 0 || row < 0 || col > WIDTH || row >= HEIGHT)
-        return bg_typ;
-    return levl[col][row].typ;
+    int i, j;
+
+    (void) memset((genericptr_t) plane, 0, COLNO * sizeof (mapcol));
+    for (i = 1; i <= WIDTH; i++)
+        for (j = 0; j < HEIGHT; j++)
+            if (levl[i][j].typ == fg_typ)
+                plane[i] |= ((mapcol) 1) << j;
 }
 
-staticfn const int dirs[16] = {
-    -1, -1 /**/, -1,  0 /**/, -1, 1 /**/, 0, -1 /**/,
-     0,  1 /**/,  1, -1 /**/,  1, 0 /**/, 1,  1
-};
+/* add one neighbour (0 or 1 per row) into the per-row counts */
+staticfn void
+count_add(struct nbcount *nb, mapcol x)
+{
+    mapcol carry;
+
+    carry = nb->b0 & x;
+    nb->b0 ^= x;
+    x = carry;
+    carry = nb->b1 & x;
+    nb->b1 ^= x;
+    x = carry;
+    carry = nb->b2 & x;
+    nb->b2 ^= x;
+    nb->b3 |= carry; /* never more than 8, so b3 can't carry */
+}
 
+/* count fg neighbours for every row of the column between lft and rgt;
+   'mid' is the column itself, whose own bit doesn't count */
 staticfn void
-pass_one(schar bg_typ, schar fg_typ)
+count_neighbours(struct nbcount *nb, mapcol lft, mapcol mid, mapcol rgt)
 {
-    int i, j;
-    short count, dr;
+    nb->b0 = nb->b1 = nb->b2 = nb->b3 = 0;
+    /* x << 1 puts the row above into each bit, x >> 1 the row below */
+    count_add(nb, lft << 1);
+    count_add(nb, lft);
+    count_add(nb, lft >> 1);
+    count_add(nb, mid << 1);
+    count_add(nb, mid >> 1);
+    count_add(nb, rgt << 1);
+    count_add(nb, rgt);
+    count_add(nb, rgt >> 1);
+}
 
-    for (i = 2; i <= WIDTH; i++)
+/* set the locations of column col picked out by rows to background */
+staticfn void
+set_bg_rows(int col, mapcol rows, schar bg_typ)
+{
+    int j;
+
+    for (j = 1; j < HEIGHT; j++)
+        if (rows & (((mapcol) 1) << j))
+            levl[col][j].typ = bg_typ;
+}
+
+staticfn void
+pass_one(schar bg_typ, schar fg_typ)
+{
+    int i, j, count;
+    mapcol plane[COLNO], col, bit;
+    struct nbcount nb;
+
+    fill_planes(plane, fg_typ);
+    for (i = 2; i <= WIDTH; i++) {
+        /* this pass updates the map in place; the column to the left
+           has already been done and the one to the right hasn't been
+           touched, so both can be counted at once.  Within the column,
+           each location sees the one above it after its update and
+           the one below it before, so that part goes row by row. */
+        count_neighbours(&nb, plane[i - 1], 0, plane[i + 1]);
+        col = plane[i];
         for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
-                    count++;
-
-            switch (count) {
-            case 0: /* death */
-            case 1:
-            case 2:
+            count = (int) ((nb.b0 >> j) & 1)
+                    + (int) (((nb.b1 >> j) & 1) << 1)
+                    + (int) (((nb.b2 >> j) & 1) << 2)
+                    + (int) ((col >> (j - 1)) & 1)
+                    + (int) ((col >> (j + 1)) & 1);
+            bit = ((mapcol) 1) << j;
+            if (count <= 2) { /* death */
                 levl[i][j].typ = bg_typ;
-                break;
-            case 5:
-            case 6:
-            case 7:
-            case 8:
+                col &= ~bit;
+            } else if (count >= 5) {
                 levl[i][j].typ = fg_typ;
-                break;
-            default:
-                break;
+                col |= bit;
             }
         }
+        plane[i] = col;
+    }
 }
 
-#define new_loc(i, j) *(gn.new_locations + ((j) * (WIDTH + 1)) + (i))
-
 staticfn void
 pass_two(schar bg_typ, schar fg_typ)
 {
-    int i, j;
-    short count, dr;
-
-    for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
-                    count++;
-            if (count == 5)
-                new_loc(i, j) = bg_typ;
-            else
-                new_loc(i, j) = get_map(i, j, bg_typ);
-        }
-
-    for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++)
-            levl[i][j].typ = new_loc(i, j);
+    int i;
+    mapcol plane[COLNO];
+    struct nbcount nb;
+
+    /* every count comes from the unmodified plane, so the map itself
+       can be updated as we go */
+    fill_planes(plane, fg_typ);
+    for (i = 2; i <= WIDTH; i++) {
+        count_neighbours(&nb, plane[i - 1], plane[i], plane[i + 1]);
+        /* exactly 5 */
+        set_bg_rows(i, nb.b0 & ~nb.b1 & nb.b2 & ~nb.b3 & MAPCOL_ROWS,
+                    bg_typ);
+    }
 }
 
 staticfn void
 pass_three(schar bg_typ, schar fg_typ)
 {
-    int i, j;
-    short count, dr;
-
-    for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
-                    count++;
-            if (count < 3)
-                new_loc(i, j) = bg_typ;
-            else
-                new_loc(i, j) = get_map(i, j, bg_typ);
-        }
-
-    for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++)
-            levl[i][j].typ = new_loc(i, j);
+    int i;
+    mapcol plane[COLNO];
+    struct nbcount nb;
+
+    fill_planes(plane, fg_typ);
+    for (i = 2; i <= WIDTH; i++) {
+        count_neighbours(&nb, plane[i - 1], plane[i], plane[i + 1]);
+        /* fewer than 3 */
+        set_bg_rows(i, ~nb.b3 & ~nb.b2 & ~(nb.b1 & nb.b0) & MAPCOL_ROWS,
+                    bg_typ);
+    }
 }
 
 /*
@@ -458,8 +515,6 @@ mkmap(lev_init *init_lev)
 
     lit = litstate_rnd(lit);
 
-    gn.new_locations = (char *) alloc((WIDTH + 1) * HEIGHT);
-
     init_map(bg_typ);
     init_fill(bg_typ, fg_typ);
 
@@ -483,7 +538,6 @@ mkmap(lev_init *init_lev)
         gl.level.flags.is_maze_lev = FALSE;
         gl.level.flags.is_cavernous_lev = TRUE;
     }
-    free(gn.new_locations);
 }
 
 /*mkmap.c*/
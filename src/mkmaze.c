@@ -6,11 +6,10 @@
 #include "hack.h"
 #include "sp_lev.h"
 
-staticfn int iswall(coordxy, coordxy);
-staticfn int iswall_or_stone(coordxy, coordxy);
-staticfn boolean is_solid(coordxy, coordxy);
-staticfn int extend_spine(int[3][3], int, int, int);
-staticfn void wall_cleanup(coordxy, coordxy, coordxy, coordxy);
+staticfn void init_spine_block(void);
+staticfn void wall_nbrs(coordxy, coordxy, int *, int *, int *);
+staticfn void wall_cleanup(coordxy, coordxy);
+staticfn void fix_wall_spine(coordxy, coordxy);
 staticfn boolean okay(coordxy, coordxy, coordxy);
 staticfn void maze0xy(coord *);
 staticfn boolean put_lregion_here(coordxy, coordxy, coordxy, coordxy, coordxy,
@@ -40,35 +39,6 @@ staticfn boolean is_exclusion_zone(xint16, coordxy, coordxy);
         }                                                        \
     } while (0)
 
-staticfn int
-iswall(coordxy x, coordxy y)
-{
-    int type;
-
-    if (!isok(x, y))
-        return 0;
-    type = levl[x][y].typ;
-    return (IS_WALL(type) || IS_DOOR(type)
-            || type == SDOOR || type == IRONBARS);
-}
-
-staticfn int
-iswall_or_stone(coordxy x, coordxy y)
-{
-    /* out of bounds = stone */
-    if (!isok(x, y))
-        return 1;
-
-    return (levl[x][y].typ == STONE || iswall(x, y));
-}
-
-/* return TRUE if out of bounds, wall or rock */
-staticfn boolean
-is_solid(coordxy x, coordxy y)
-{
-    return (boolean) (!isok(x, y) || IS_STWALL(levl[x][y].typ));
-}
-
 /* set map terrain type, handling lava lit, ice melt timers, etc */
 boolean
 set_levltyp(coordxy x, coordxy y, schar newtyp)
@@ -89,6 +59,7 @@ set_levltyp(coordxy x, coordxy y, schar newtyp)
 
             if (was_ice && newtyp != ICE)
                 spot_stop_timers(x, y, MELT_ICE_AWAY);
+            freecell_newterrain(x, y);
             if ((IS_FOUNTAIN(oldtyp) != IS_FOUNTAIN(newtyp))
                 || (IS_SINK(oldtyp) != IS_SINK(newtyp)))
                 count_level_features(); /* level.flags.nfountains,nsinks */
@@ -131,14 +102,10 @@ set_levltyp_lit(coordxy x, coordxy y, schar typ, schar lit)
 }
 
 /*
- * Return 1 (not TRUE - we're doing bit vectors here) if we want to extend
- * a wall spine in the (dx,dy) direction.  Return 0 otherwise.
- *
- * To extend a wall spine in that direction, first there must be a wall there.
- * Then, extend a spine unless the current position is surrounded by walls
- * in the direction given by (dx,dy).  E.g. if 'x' is our location, 'W'
- * a wall, '.' a room, 'a' anything (we don't care), and our direction is
- * (0,1) - South or down - then:
+ * Wall spines.  A wall extends a spine toward an adjacent wall unless
+ * it is surrounded by walls (or stone) on that side.  E.g. if 'x' is our
+ * location, 'W' a wall, '.' a room, 'a' anything (we don't care), and
+ * the direction is South or down, then:
  *
  *              a a a
  *              W x W           This would not extend a spine from x down
@@ -147,136 +114,168 @@ set_levltyp_lit(coordxy x, coordxy y, schar typ, schar lit)
  *              a a a
  *              W x W           This would extend a spine from x down.
  *              . W W
+ *
+ * The 8 neighbours are gathered into a WN_xx mask (see rm.h) and
+ * spine_block[] gives the directions in which that mask rules a spine
+ * out, so each wall is resolved with one lookup.  Spine directions are
+ * bit vectors: North 8, South 4, East 2, West 1.
  */
-staticfn int
-extend_spine(int locale[3][3], int wall_there, int dx, int dy)
+#define SPINE_N 8
+#define SPINE_S 4
+#define SPINE_E 2
+#define SPINE_W 1
+
+static uchar spine_block[256];
+static boolean spine_block_ready = FALSE;
+
+/* all of 'bits' set in 'mask' */
+#define all_wn(mask, bits) (((mask) & (bits)) == (bits))
+
+staticfn void
+init_spine_block(void)
 {
-    int spine, nx, ny;
+    int mask;
+
+    for (mask = 0; mask < 256; mask++)
+        spine_block[mask]
+            = (all_wn(mask, WN_L | WN_R | WN_TL | WN_TR) ? SPINE_N : 0)
+              | (all_wn(mask, WN_L | WN_R | WN_BL | WN_BR) ? SPINE_S : 0)
+              | (all_wn(mask, WN_T | WN_B | WN_TR | WN_BR) ? SPINE_E : 0)
+              | (all_wn(mask, WN_T | WN_B | WN_TL | WN_BL) ? SPINE_W : 0);
+}
 
-    nx = 1 + dx;
-    ny = 1 + dy;
+/* the walls orthogonally adjacent to a location, as spine directions */
+#define wn_spines(walls) \
+    ((((walls) & WN_T) ? SPINE_N : 0) | (((walls) & WN_B) ? SPINE_S : 0) \
+     | (((walls) & WN_R) ? SPINE_E : 0) | (((walls) & WN_L) ? SPINE_W : 0))
 
-    if (wall_there) { /* wall in that direction */
-        if (dx) {
-            if (locale[1][0] && locale[1][2]         /* EW are wall/stone */
-                && locale[nx][0] && locale[nx][2]) { /* diag are wall/stone */
-                spine = 0;
-            } else {
-                spine = 1;
-            }
-        } else { /* dy */
-            if (locale[0][1] && locale[2][1]         /* NS are wall/stone */
-                && locale[0][ny] && locale[2][ny]) { /* diag are wall/stone */
-                spine = 0;
-            } else {
-                spine = 1;
-            }
+/*
+ * Neighbour masks for <x,y>:  which adjacent locations are walls (doors
+ * and iron bars included), which are stone (off the map counts as stone),
+ * and which are solid rock or wall.
+ */
+staticfn void
+wall_nbrs(coordxy x, coordxy y, int *walls, int *stone, int *solid)
+{
+    static const schar wn_dx[8] = { -1, 0, 1, 1, 1, 0, -1, -1 },
+                       wn_dy[8] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+    coordxy nx, ny;
+    int i, typ;
+
+    *walls = *stone = *solid = 0;
+    for (i = 0; i < 8; i++) {
+        nx = x + wn_dx[i], ny = y + wn_dy[i];
+        if (!isok(nx, ny)) {
+            *stone |= 1 << i;
+            *solid |= 1 << i;
+            continue;
         }
-    } else {
-        spine = 0;
+        typ = levl[nx][ny].typ;
+        if (IS_WALL(typ) || IS_DOOR(typ) || typ == SDOOR || typ == IRONBARS)
+            *walls |= 1 << i;
+        else if (typ == STONE)
+            *stone |= 1 << i;
+        if (IS_STWALL(typ))
+            *solid |= 1 << i;
     }
-
-    return spine;
 }
 
-/* Remove walls totally surrounded by stone */
+/* Remove a wall totally surrounded by stone */
 staticfn void
-wall_cleanup(coordxy x1, coordxy y1, coordxy x2, coordxy y2)
+wall_cleanup(coordxy x, coordxy y)
 {
-    uchar type;
-    coordxy x, y;
-    struct rm *lev;
-
-    /* sanity check on incoming variables */
-    if (x1 < 0 || x2 >= COLNO || x1 > x2 || y1 < 0 || y2 >= ROWNO || y1 > y2)
-        panic("wall_cleanup: bad bounds (%d,%d) to (%d,%d)", x1, y1, x2, y2);
+    struct rm *lev = &levl[x][y];
+    int walls, stone, solid;
 
-    /* change walls surrounded by rock to rock. */
-    for (x = x1; x <= x2; x++)
-        for (y = y1; y <= y2; y++) {
-            if (within_bounded_area(x, y,
-                                  gb.bughack.inarea.x1, gb.bughack.inarea.y1,
-                                  gb.bughack.inarea.x2, gb.bughack.inarea.y2))
-                continue;
-            lev = &levl[x][y];
-            type = lev->typ;
-            if (IS_WALL(type) && type != DBWALL) {
-                if (is_solid(x - 1, y - 1) && is_solid(x - 1, y)
-                    && is_solid(x - 1, y + 1) && is_solid(x, y - 1)
-                    && is_solid(x, y + 1) && is_solid(x + 1, y - 1)
-                    && is_solid(x + 1, y) && is_solid(x + 1, y + 1))
-                    lev->typ = STONE;
-            }
-        }
+    if (!IS_WALL(lev->typ) || lev->typ == DBWALL
+        || within_bounded_area(x, y,
+                               gb.bughack.inarea.x1, gb.bughack.inarea.y1,
+                               gb.bughack.inarea.x2, gb.bughack.inarea.y2))
+        return;
+    wall_nbrs(x, y, &walls, &stone, &solid);
+    /* walls becoming stone stay solid, so the order locations are
+       visited in doesn't matter */
+    if (solid == 0xff)
+        lev->typ = STONE;
 }
 
-/* Correct wall types so they extend and connect to each other */
-void
-fix_wall_spines(coordxy x1, coordxy y1, coordxy x2, coordxy y2)
+/* Correct a wall's type so it extends and connects to its neighbours */
+staticfn void
+fix_wall_spine(coordxy x, coordxy y)
 {
-    uchar type;
-    coordxy x, y;
-    struct rm *lev;
-    int (*loc_f)(coordxy, coordxy);
-    int bits;
-    int locale[3][3]; /* rock or wall status surrounding positions */
-
     /*
      * Value 0 represents a free-standing wall.  It could be anything,
      * so even though this table says VWALL, we actually leave whatever
      * typ was there alone.
      */
-    static xint16 spine_array[16] = { VWALL, HWALL,    HWALL,    HWALL,
-                                     VWALL, TRCORNER, TLCORNER, TDWALL,
-                                     VWALL, BRCORNER, BLCORNER, TUWALL,
-                                     VWALL, TLWALL,   TRWALL,   CROSSWALL };
+    static const xint16 spine_array[16] = {
+        VWALL, HWALL,    HWALL,    HWALL,
+        VWALL, TRCORNER, TLCORNER, TDWALL,
+        VWALL, BRCORNER, BLCORNER, TUWALL,
+        VWALL, TLWALL,   TRWALL,   CROSSWALL
+    };
+    struct rm *lev = &levl[x][y];
+    int walls, stone, solid, locale, bits;
+
+    if (!IS_WALL(lev->typ) || lev->typ == DBWALL)
+        return;
+    if (!spine_block_ready) {
+        init_spine_block();
+        spine_block_ready = TRUE;
+    }
+
+    wall_nbrs(x, y, &walls, &stone, &solid);
+    /* rock or wall status of surrounding positions; stone doesn't
+       count inside the baalz insect */
+    locale = walls;
+    if (!within_bounded_area(x, y,
+                             gb.bughack.inarea.x1, gb.bughack.inarea.y1,
+                             gb.bughack.inarea.x2, gb.bughack.inarea.y2))
+        locale |= stone;
+    bits = wn_spines(walls) & ~spine_block[locale];
+
+    /* don't change typ if wall is free-standing; changing one wall
+       type into another doesn't affect any neighbour's result */
+    if (bits)
+        lev->typ = spine_array[bits];
+}
+
+/* Correct wall types so they extend and connect to each other */
+void
+fix_wall_spines(coordxy x1, coordxy y1, coordxy x2, coordxy y2)
+{
+    coordxy x, y;
 
     /* sanity check on incoming variables */
     if (x1 < 0 || x2 >= COLNO || x1 > x2 || y1 < 0 || y2 >= ROWNO || y1 > y2)
         panic("wall_extends: bad bounds (%d,%d) to (%d,%d)", x1, y1, x2, y2);
 
-    /* set the correct wall type. */
     for (x = x1; x <= x2; x++)
-        for (y = y1; y <= y2; y++) {
-            lev = &levl[x][y];
-            type = lev->typ;
-            if (!(IS_WALL(type) && type != DBWALL))
-                continue;
-
-            /* set the locations TRUE if rock or wall or out of bounds */
-            loc_f = within_bounded_area(x, y, /* for baalz insect */
-                                   gb.bughack.inarea.x1, gb.bughack.inarea.y1,
-                                   gb.bughack.inarea.x2, gb.bughack.inarea.y2)
-                       ? iswall
-                       : iswall_or_stone;
-            locale[0][0] = (*loc_f)(x - 1, y - 1);
-            locale[1][0] = (*loc_f)(x, y - 1);
-            locale[2][0] = (*loc_f)(x + 1, y - 1);
-
-            locale[0][1] = (*loc_f)(x - 1, y);
-            locale[2][1] = (*loc_f)(x + 1, y);
-
-            locale[0][2] = (*loc_f)(x - 1, y + 1);
-            locale[1][2] = (*loc_f)(x, y + 1);
-            locale[2][2] = (*loc_f)(x + 1, y + 1);
-
-            /* determine if wall should extend to each direction NSEW */
-            bits = (extend_spine(locale, iswall(x, y - 1), 0, -1) << 3)
-                   | (extend_spine(locale, iswall(x, y + 1), 0, 1) << 2)
-                   | (extend_spine(locale, iswall(x + 1, y), 1, 0) << 1)
-                   | extend_spine(locale, iswall(x - 1, y), -1, 0);
-
-            /* don't change typ if wall is free-standing */
-            if (bits)
-                lev->typ = spine_array[bits];
-        }
+        for (y = y1; y <= y2; y++)
+            fix_wall_spine(x, y);
 }
 
+/* Remove walls surrounded by rock, then shape the rest; done in a
+   single sweep, with the shaping one column behind the clean-up so that
+   it only looks at neighbours which have already been cleaned */
 void
 wallification(coordxy x1, coordxy y1, coordxy x2, coordxy y2)
 {
-    wall_cleanup(x1, y1, x2, y2);
-    fix_wall_spines(x1, y1, x2, y2);
+    coordxy x, y;
+
+    /* sanity check on incoming variables */
+    if (x1 < 0 || x2 >= COLNO || x1 > x2 || y1 < 0 || y2 >= ROWNO || y1 > y2)
+        panic("wallification: bad bounds (%d,%d) to (%d,%d)",
+              x1, y1, x2, y2);
+
+    for (x = x1; x <= x2 + 1; x++) {
+        if (x <= x2)
+            for (y = y1; y <= y2; y++)
+                wall_cleanup(x, y);
+        if (x > x1)
+            for (y = y1; y <= y2; y++)
+                fix_wall_spine(x - 1, y);
+    }
 }
 
 staticfn boolean
@@ -1489,9 +1488,47 @@ fumaroles(void)
 #define gbymax (gy.ymax - 1)
 
 staticfn void set_wportal(void);
+staticfn void bubble_block(coordxy, coordxy);
+staticfn void bubble_touch(coordxy, coordxy, boolean);
 staticfn void mk_bubble(coordxy, coordxy, int);
 staticfn void mv_bubble(struct bubble *, coordxy, coordxy, boolean);
 
+/*
+ * Locations whose terrain movebubbles() has rewritten this turn.  A
+ * location can be reset to water and then become part of a bubble again
+ * (or vice versa on the Plane of Air), so telling vision whether it
+ * blocks sight waits until all the bubbles have moved, and then is only
+ * done for these locations rather than for the whole level.
+ */
+static coord bubble_dirty[COLNO * ROWNO];
+static int bubble_ndirty = 0;
+static char bubble_dirtymap[COLNO][ROWNO];
+
+/* let vision know whether <x,y> blocks sight, going by its terrain */
+staticfn void
+bubble_block(coordxy x, coordxy y)
+{
+    if (levl[x][y].typ == WATER || levl[x][y].typ == CLOUD)
+        block_point(x, y);
+    else
+        unblock_point(x, y);
+}
+
+/* the terrain at <x,y> has been rewritten; if 'defer', leave the vision
+   update until movebubbles() has finished moving every bubble */
+staticfn void
+bubble_touch(coordxy x, coordxy y, boolean defer)
+{
+    if (!defer) {
+        bubble_block(x, y);
+    } else if (!bubble_dirtymap[x][y]) {
+        bubble_dirtymap[x][y] = 1;
+        bubble_dirty[bubble_ndirty].x = x;
+        bubble_dirty[bubble_ndirty].y = y;
+        ++bubble_ndirty;
+    }
+}
+
 void
 movebubbles(void)
 {
@@ -1510,8 +1547,12 @@ movebubbles(void)
     if (!gw.wportal)
         set_wportal();
 
-    vision_recalc(2);
-
+    /*
+     * Vision isn't turned off while the bubbles move.  Every location
+     * whose terrain gets rewritten has its seen vector cleared, so the
+     * next vision_recalc() redraws exactly those of them which are in
+     * view; the rest of the map hasn't changed.
+     */
     if (Is_waterlevel(&u.uz)) {
         /* keep attached ball&chain separate from bubble objects */
         if (Punished)
@@ -1589,13 +1630,14 @@ movebubbles(void)
                             cons->y = y;
                             cons->what = CONS_TRAP;
                             cons->list = (genericptr_t) btrap;
+                            gl.level.traps[x][y] = (struct trap *) 0;
 
                             cons->next = b->cons;
                             b->cons = cons;
                         }
 
                         levl[x][y] = water_pos;
-                        block_point(x, y);
+                        bubble_touch(x, y, TRUE);
                     }
         }
     } else if (Is_airlevel(&u.uz)) {
@@ -1603,18 +1645,21 @@ movebubbles(void)
 
         for (x = 1; x <= (COLNO - 1); x++)
             for (y = 0; y <= (ROWNO - 1); y++) {
+                xedge = (boolean) (x < gbxmin || x > gbxmax);
+                yedge = (boolean) (y < gbymin || y > gbymax);
+                /* open air stays as it is; only clouds, and anything
+                   else which has turned up, need to be cleared away */
+                if (!xedge && !yedge
+                    && levl[x][y].typ == AIR && levl[x][y].lit)
+                    continue;
                 levl[x][y] = air_pos;
-                unblock_point(x, y);
                 /* all air or all cloud around the perimeter of the Air
                    level tends to look strange; break up the pattern */
-                xedge = (boolean) (x < gbxmin || x > gbxmax);
-                yedge = (boolean) (y < gbymin || y > gbymax);
                 if (xedge || yedge) {
-                    if (!rn2(xedge ? 3 : 5)) {
+                    if (!rn2(xedge ? 3 : 5))
                         levl[x][y].typ = CLOUD;
-                        block_point(x, y);
-                    }
                 }
+                bubble_touch(x, y, TRUE);
             }
     }
 
@@ -1631,6 +1676,14 @@ movebubbles(void)
                   b->dy + 1 - (!b->dy ? ry : (ry ? 1 : 0)), FALSE);
     }
 
+    /* bring vision's blocked/clear map up to date */
+    for (i = 0; i < bubble_ndirty; i++) {
+        x = bubble_dirty[i].x, y = bubble_dirty[i].y;
+        bubble_dirtymap[x][y] = 0;
+        bubble_block(x, y);
+    }
+    bubble_ndirty = 0;
+
     /* put attached ball&chain back */
     if (Is_waterlevel(&u.uz) && Punished)
         lift_covet_and_placebc(bcpin);
@@ -1947,16 +2000,17 @@ mv_bubble(struct bubble *b, coordxy dx, coordxy dy, boolean ini)
     /* draw the bubbles */
     for (i = 0, x = b->x; i < (int) b->bm[0]; i++, x++)
         for (j = 0, y = b->y; j < (int) b->bm[1]; j++, y++)
-            if (b->bm[j + 2] & (1 << i)) {
-                if (Is_waterlevel(&u.uz)) {
-                    levl[x][y].typ = AIR;
-                    levl[x][y].lit = 1;
-                    unblock_point(x, y);
-                } else if (Is_airlevel(&u.uz)) {
-                    levl[x][y].typ = CLOUD;
-                    levl[x][y].lit = 1;
-                    block_point(x, y);
-                }
+            if ((b->bm[j + 2] & (1 << i))
+                && (Is_waterlevel(&u.uz) || Is_airlevel(&u.uz))) {
+                schar typ = Is_waterlevel(&u.uz) ? AIR : CLOUD;
+
+                /* a location which changes has to be redrawn; clearing
+                   its seen vector gets vision to do that */
+                if (levl[x][y].typ != typ)
+                    levl[x][y].seenv = 0;
+                levl[x][y].typ = typ;
+                levl[x][y].lit = 1;
+                bubble_touch(x, y, !ini);
             }
 
     if (Is_waterlevel(&u.uz)) {
@@ -2006,6 +2060,7 @@ mv_bubble(struct bubble *b, coordxy dx, coordxy dy, boolean ini)
 
                 btrap->tx = cons->x;
                 btrap->ty = cons->y;
+                gl.level.traps[cons->x][cons->y] = btrap;
                 break;
             }
 
@@ -9,14 +9,20 @@ staticfn boolean may_generate_eroded(struct obj *);
 staticfn void mkobj_erosions(struct obj *);
 staticfn void mkbox_cnts(struct obj *);
 staticfn unsigned nextoid(struct obj *, struct obj *);
+staticfn unsigned id_index_slot(struct id_index *, unsigned);
+staticfn void id_index_grow(struct id_index *);
+staticfn void id_index_objs(struct obj *);
 staticfn void mksobj_init(struct obj *, boolean);
 staticfn int item_on_ice(struct obj *);
 staticfn void shrinking_glob_gone(struct obj *);
 staticfn void obj_timer_checks(struct obj *, coordxy, coordxy, int);
 staticfn struct obj *save_mtraits(struct obj *, struct monst *);
 staticfn void objlist_sanity(struct obj *, int, const char *);
+staticfn void obj_sanity(struct obj *, int, const char *);
 staticfn void shop_obj_sanity(struct obj *, const char *);
 staticfn void mon_obj_sanity(struct monst *, const char *);
+staticfn void mon_invent_obj_sanity(struct monst *, struct obj *,
+                                    const char *);
 staticfn void insane_obj_bits(struct obj *, struct monst *);
 staticfn boolean nomerge_exception(struct obj *);
 staticfn const char *where_name(struct obj *);
@@ -86,7 +92,7 @@ newoextra(void)
 {
     struct oextra *oextra;
 
-    oextra = (struct oextra *) alloc(sizeof (struct oextra));
+    oextra = (struct oextra *) nhpool_get(&oextra_pool);
     init_oextra(oextra);
     return oextra;
 }
@@ -104,7 +110,7 @@ dealloc_oextra(struct obj *o)
         if (x->omailcmd)
             free((genericptr_t) x->omailcmd), x->omailcmd = 0;
 
-        free((genericptr_t) x);
+        nhpool_put(&oextra_pool, (genericptr_t) x);
         o->oextra = (struct oextra *) 0;
     }
 }
@@ -132,7 +138,7 @@ free_omonst(struct obj *otmp)
         if (m) {
             if (m->mextra)
                 dealloc_mextra(m);
-            free((genericptr_t) m);
+            nhpool_put(&monst_pool, (genericptr_t) m);
             OMONST(otmp) = (struct monst *) 0;
         }
     }
@@ -545,6 +551,151 @@ nextoid(struct obj *oldobj, struct obj *newobj)
     return oid; /* caller will use this ident */
 }
 
+/*
+ * struct id_index is a hash table keyed by o_id or m_id, using open
+ * addressing with linear probing.  Entries are never removed one at a
+ * time; the whole table is discarded by id_index_free().
+ */
+
+/* find the slot holding 'id', or the empty slot where it would go */
+staticfn unsigned
+id_index_slot(struct id_index *idx, unsigned id)
+{
+    unsigned mask = idx->size - 1, hash = id * 2654435761U;
+
+    hash ^= hash >> 16;
+    for (hash &= mask; idx->ids[hash] && idx->ids[hash] != id;
+         hash = (hash + 1) & mask)
+        continue;
+    return hash;
+}
+
+staticfn void
+id_index_grow(struct id_index *idx)
+{
+    struct id_index old = *idx;
+    unsigned i, s;
+
+    idx->size = old.size ? old.size * 2 : 256;
+    idx->ids = (unsigned *) alloc(idx->size * sizeof (unsigned));
+    idx->vals = (anything *) alloc(idx->size * sizeof (anything));
+    (void) memset((genericptr_t) idx->ids, 0, idx->size * sizeof (unsigned));
+    for (i = 0; i < old.size; ++i)
+        if (old.ids[i]) {
+            s = id_index_slot(idx, old.ids[i]);
+            idx->ids[s] = old.ids[i];
+            idx->vals[s] = old.vals[i];
+        }
+    if (old.size) {
+        free((genericptr_t) old.ids);
+        free((genericptr_t) old.vals);
+    }
+}
+
+/* add id -> val; if id is already present, its old value is kept
+   unless 'replace' is set; 0 is never added */
+void
+id_index_add(struct id_index *idx, unsigned id, anything val,
+             boolean replace)
+{
+    unsigned s;
+
+    if (!id)
+        return;
+    if ((idx->count + 1) * 2 > idx->size)
+        id_index_grow(idx);
+    s = id_index_slot(idx, id);
+    if (!idx->ids[s]) {
+        idx->ids[s] = id;
+        idx->vals[s] = val;
+        idx->count++;
+    } else if (replace) {
+        idx->vals[s] = val;
+    }
+}
+
+anything *
+id_index_find(struct id_index *idx, unsigned id)
+{
+    unsigned s;
+
+    if (!idx->count || !id)
+        return (anything *) 0;
+    s = id_index_slot(idx, id);
+    return idx->ids[s] ? &idx->vals[s] : (anything *) 0;
+}
+
+void
+id_index_free(struct id_index *idx)
+{
+    if (idx->size) {
+        free((genericptr_t) idx->ids);
+        free((genericptr_t) idx->vals);
+    }
+    idx->ids = (unsigned *) 0;
+    idx->vals = (anything *) 0;
+    idx->size = idx->count = 0;
+}
+
+/* index a chain of objects and their contents in the order that o_on()
+   would come across them, so that the first one found is the one kept */
+staticfn void
+id_index_objs(struct obj *objchn)
+{
+    anything any;
+
+    for (; objchn; objchn = objchn->nobj) {
+        any = cg.zeroany;
+        any.a_obj = objchn;
+        id_index_add(&gi.oid_index, objchn->o_id, any, FALSE);
+        if (Has_contents(objchn))
+            id_index_objs(objchn->cobj);
+    }
+}
+
+/* index every object find_oid() can find and every monster that
+   find_mid(,FM_EVERYWHERE) can, for a caller about to look up a lot of
+   them; until the matching id_index_end(), no object or monster may be
+   created, destroyed, renumbered, or moved to a different list */
+void
+id_index_begin(void)
+{
+    struct monst *mon, *mmtmp[3];
+    anything any;
+    int i;
+
+    if (gi.id_index_depth++)
+        return;
+    id_index_objs(gi.invent);
+    id_index_objs(fobj);
+    id_index_objs(gl.level.buriedobjlist);
+    id_index_objs(gm.migrating_objs);
+    mmtmp[0] = fmon;
+    mmtmp[1] = gm.migrating_mons;
+    mmtmp[2] = gm.mydogs;
+    for (i = 0; i < 3; i++)
+        for (mon = mmtmp[i]; mon; mon = mon->nmon)
+            id_index_objs(mon->minvent);
+    for (i = 0; i < 3; i++)
+        for (mon = mmtmp[i]; mon; mon = mon->nmon) {
+            /* find_mid() skips dead monsters on fmon but not elsewhere */
+            if (i == 0 && DEADMONSTER(mon))
+                continue;
+            any = cg.zeroany;
+            any.a_monst = mon;
+            id_index_add(&gi.mid_index, mon->m_id, any, FALSE);
+        }
+}
+
+void
+id_index_end(void)
+{
+    if (gi.id_index_depth > 0 && !--gi.id_index_depth) {
+        id_index_free(&gi.oid_index);
+        id_index_free(&gi.mid_index);
+    }
+}
+
 /* try to find the stack obj was split from, then merge them back together;
    returns the combined object if unsplit is successful, null otherwise */
 struct obj *
@@ -644,6 +795,7 @@ replace_object(struct obj *obj, struct obj *otmp)
         otmp->nobj = obj->nobj;
         obj->nobj = otmp;
         extract_nobj(obj, &gi.invent);
+        minvent_changed(&gy.youmonst);
         break;
     case OBJ_CONTAINED:
         otmp->nobj = obj->nobj;
@@ -656,6 +808,7 @@ replace_object(struct obj *obj, struct obj *otmp)
         otmp->ocarry = obj->ocarry;
         obj->nobj = otmp;
         extract_nobj(obj, &obj->ocarry->minvent);
+        minvent_changed(otmp->ocarry);
         break;
     case OBJ_FLOOR:
         otmp->nobj = obj->nobj;
@@ -2283,6 +2436,7 @@ place_object(struct obj *otmp, coordxy x, coordxy y)
     fobj = otmp;
     if (otmp->timed)
         obj_timer_checks(otmp, x, y, 0);
+    sanity_touch_obj(otmp);
 }
 
 /* tear down the object pile at <x,y> and create it again, so that any
@@ -2492,6 +2646,7 @@ obj_extract_self(struct obj *obj)
         break;
     case OBJ_MINVENT:
         extract_nobj(obj, &obj->ocarry->minvent);
+        minvent_changed(obj->ocarry);
         obj->ocarry = (struct monst *) 0; /* clear stale back-link */
         break;
     case OBJ_MIGRATING:
@@ -2579,6 +2734,8 @@ add_to_minv(struct monst *mon, struct obj *obj)
     obj->ocarry = mon;
     obj->nobj = mon->minvent;
     mon->minvent = obj;
+    minvent_changed(mon);
+    sanity_touch_obj(obj);
     return 0; /* obj on mon's inventory chain */
 }
 
@@ -2609,6 +2766,7 @@ add_to_container(struct obj *container, struct obj *obj)
     obj->ocontainer = container;
     obj->nobj = container->cobj;
     container->cobj = obj;
+    sanity_touch_obj(obj);
     return obj;
 }
 
@@ -2632,6 +2790,7 @@ add_to_migration(struct obj *obj)
     obj->omigr_from_dnum = u.uz.dnum;
     obj->omigr_from_dlevel = u.uz.dlevel;
     gm.migrating_objs = obj;
+    sanity_touch_obj(obj);
 }
 
 void
@@ -2643,6 +2802,7 @@ add_to_buried(struct obj *obj)
     obj->where = OBJ_BURIED;
     obj->nobj = gl.level.buriedobjlist;
     gl.level.buriedobjlist = obj;
+    sanity_touch_obj(obj);
 }
 
 /* recalculate weight of object, which doesn't have to be a container
@@ -2694,6 +2854,7 @@ dealloc_obj(struct obj *obj)
         gt.thrownobj = 0;
     if (obj == gk.kickedobj)
         gk.kickedobj = 0;
+    sanity_forget_obj(obj);
 
     if (obj->oextra)
         dealloc_oextra(obj);
@@ -2709,7 +2870,7 @@ dealloc_obj(struct obj *obj)
        linking with a debugging malloc library is likely to do something
        similar so this is mainly useful for ordinary malloc/free */
     *obj = cg.zeroobj;
-    free((genericptr_t) obj);
+    nhpool_put(&obj_pool, (genericptr_t) obj);
 }
 
 /* create an object from a horn of plenty; mirrors bagotricks(makemon.c) */
@@ -2819,7 +2980,6 @@ void
 obj_sanity_check(void)
 {
     coordxy x, y;
-    struct obj *obj, *otop, *prevo;
 
     objlist_sanity(fobj, OBJ_FLOOR, "floor sanity");
 
@@ -2827,40 +2987,8 @@ obj_sanity_check(void)
        those objects should have already been sanity checked via
        the floor list so container contents are skipped here */
     for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++) {
-            char at_fmt[BUFSZ];
-
-            otop = gl.level.objects[x][y];
-            prevo = 0;
-            for (obj = otop; obj; prevo = obj, obj = prevo->nexthere) {
-                /* <ox,oy> should match <x,y>; <0,*> should always be empty */
-                if (obj->where != OBJ_FLOOR || x == 0
-                    || obj->ox != x || obj->oy != y) {
-                    Sprintf(at_fmt, "%%s obj@<%d,%d> %%s %%s: %%s@<%d,%d>",
-                            x, y, obj->ox, obj->oy);
-                    insane_object(obj, at_fmt, "location sanity",
-                                  (struct monst *) 0);
-
-                /* when one or more boulders are present, they should always
-                   be at the top of their pile; also never in water or lava */
-                } else if (obj->otyp == BOULDER) {
-                    if (prevo && prevo->otyp != BOULDER) {
-                        Sprintf(at_fmt,
-                                "%%s boulder@<%d,%d> %%s %%s: not on top",
-                                x, y);
-                        insane_object(obj, at_fmt, "boulder sanity",
-                                      (struct monst *) 0);
-                    }
-                    if (is_pool_or_lava(x, y)) {
-                        Sprintf(at_fmt,
-                                "%%s boulder@<%d,%d> %%s %%s: on/in %s",
-                                x, y, is_pool(x, y) ? "water" : "lava");
-                        insane_object(obj, at_fmt, "boulder sanity",
-                                      (struct monst *) 0);
-                    }
-                }
-            }
-        }
+        for (y = 0; y < ROWNO; y++)
+            obj_sanity_check_at(x, y);
 
     objlist_sanity(gi.invent, OBJ_INVENT, "invent sanity");
     objlist_sanity(gm.migrating_objs, OBJ_MIGRATING, "migrating sanity");
@@ -2896,66 +3024,186 @@ obj_sanity_check(void)
                       (struct monst *) 0);
 }
 
+/* check the map's record of floor objects at one location */
+void
+obj_sanity_check_at(coordxy x, coordxy y)
+{
+    struct obj *obj, *prevo = 0;
+    char at_fmt[BUFSZ];
+
+    for (obj = gl.level.objects[x][y]; obj;
+         prevo = obj, obj = obj->nexthere) {
+        /* <ox,oy> should match <x,y>; <0,*> should always be empty */
+        if (obj->where != OBJ_FLOOR || x == 0
+            || obj->ox != x || obj->oy != y) {
+            Sprintf(at_fmt, "%%s obj@<%d,%d> %%s %%s: %%s@<%d,%d>",
+                    x, y, obj->ox, obj->oy);
+            insane_object(obj, at_fmt, "location sanity",
+                          (struct monst *) 0);
+
+        /* when one or more boulders are present, they should always
+           be at the top of their pile; also never in water or lava */
+        } else if (obj->otyp == BOULDER) {
+            if (prevo && prevo->otyp != BOULDER) {
+                Sprintf(at_fmt, "%%s boulder@<%d,%d> %%s %%s: not on top",
+                        x, y);
+                insane_object(obj, at_fmt, "boulder sanity",
+                              (struct monst *) 0);
+            }
+            if (is_pool_or_lava(x, y)) {
+                Sprintf(at_fmt, "%%s boulder@<%d,%d> %%s %%s: on/in %s",
+                        x, y, is_pool(x, y) ? "water" : "lava");
+                insane_object(obj, at_fmt, "boulder sanity",
+                              (struct monst *) 0);
+            }
+        }
+    }
+}
+
+/* check a single object which has been touched since the last pass of
+   incremental sanity checking; unlike the list-based checks, we have to
+   confirm that the object is actually on the list it claims to be on */
+void
+obj_sanity_check_one(struct obj *obj)
+{
+    struct obj *otmp, *head = (struct obj *) 0;
+    const char *mesg = "touched sanity";
+
+    switch (obj->where) {
+    case OBJ_FREE:
+    case OBJ_LUAFREE:
+        /* ball and chain can be free while hero is engulfed */
+        return;
+    case OBJ_FLOOR:
+        if (!isok(obj->ox, obj->oy)) {
+            insane_object(obj, ofmt0, "touched floor sanity [off map]",
+                          (struct monst *) 0);
+            return;
+        }
+        for (otmp = gl.level.objects[obj->ox][obj->oy]; otmp;
+             otmp = otmp->nexthere)
+            if (otmp == obj)
+                break;
+        if (!otmp)
+            insane_object(obj, ofmt0, "touched floor sanity [not in pile]",
+                          (struct monst *) 0);
+        head = fobj;
+        mesg = "touched floor sanity";
+        break;
+    case OBJ_CONTAINED:
+        if (!obj->ocontainer)
+            insane_object(obj, ofmt0, "touched contained sanity [no bag]",
+                          (struct monst *) 0);
+        else
+            check_contained(obj->ocontainer, "touched sanity");
+        return;
+    case OBJ_INVENT:
+        head = gi.invent;
+        mesg = "touched invent sanity";
+        break;
+    case OBJ_MINVENT:
+        if (!obj->ocarry) {
+            insane_object(obj, ofmt0, "touched minvent sanity [no mon]",
+                          (struct monst *) 0);
+            return;
+        }
+        head = obj->ocarry->minvent;
+        mesg = "touched minvent sanity";
+        break;
+    case OBJ_MIGRATING:
+        head = gm.migrating_objs;
+        mesg = "touched migrating sanity";
+        break;
+    case OBJ_BURIED:
+        head = gl.level.buriedobjlist;
+        mesg = "touched buried sanity";
+        break;
+    case OBJ_ONBILL:
+        head = gb.billobjs;
+        mesg = "touched bill sanity";
+        break;
+    default:
+        insane_object(obj, ofmt0, mesg, (struct monst *) 0);
+        return;
+    }
+    for (otmp = head; otmp; otmp = otmp->nobj)
+        if (otmp == obj)
+            break;
+    if (!otmp)
+        insane_object(obj, ofmt0, "touched sanity [not on its list]",
+                      (obj->where == OBJ_MINVENT) ? obj->ocarry : 0);
+    else if (obj->where == OBJ_MINVENT)
+        mon_invent_obj_sanity(obj->ocarry, obj, mesg);
+    else
+        obj_sanity(obj, obj->where, mesg);
+}
+
 /* sanity check for objects on specified list (fobj, &c) */
 staticfn void
 objlist_sanity(struct obj *objlist, int wheretype, const char *mesg)
 {
     struct obj *obj;
 
-    for (obj = objlist; obj; obj = obj->nobj) {
-        if (obj->where != wheretype)
-            insane_object(obj, ofmt0, mesg, (struct monst *) 0);
-        if (obj->where == OBJ_INVENT && obj->how_lost != LOST_NONE) {
-            char lostbuf[40];
-            Sprintf(lostbuf, "how_lost=%d obj in inventory!", obj->how_lost);
-            insane_object(obj, ofmt0, lostbuf, (struct monst *) 0);
-        }
-        if (Has_contents(obj)) {
-            if (wheretype == OBJ_ONBILL)
-                /* containers on shop bill should always be empty */
-                insane_object(obj, "%s obj contains something! %s %s: %s",
-                              mesg, (struct monst *) 0);
-            check_contained(obj, mesg);
-        }
-        if (obj->unpaid || obj->no_charge) {
-            shop_obj_sanity(obj, mesg);
-        }
-        if (obj->owornmask) {
-            char maskbuf[40];
-            boolean bc_ok = FALSE;
+    for (obj = objlist; obj; obj = obj->nobj)
+        obj_sanity(obj, wheretype, mesg);
+}
 
-            switch (obj->where) {
-            case OBJ_INVENT:
-            case OBJ_MINVENT:
-                sanity_check_worn(obj);
-                break;
-            case OBJ_MIGRATING:
-                /* migrating objects overload the owornmask field
-                   with a destination code; skip attempt to check it */
-                break;
-            case OBJ_FLOOR:
-                /* note: ball and chain can also be OBJ_FREE, but not across
-                   turns so this sanity check shouldn't encounter that */
-                bc_ok = TRUE;
-            /*FALLTHRU*/
-            default:
-                if ((obj != uchain && obj != uball) || !bc_ok) {
-                    /* discovered an object not in inventory which
-                       erroneously has worn mask set */
-                    Sprintf(maskbuf, "worn mask 0x%08lx", obj->owornmask);
-                    insane_object(obj, ofmt0, maskbuf, (struct monst *) 0);
-                }
-                break;
+/* sanity check for one object on a list */
+staticfn void
+obj_sanity(struct obj *obj, int wheretype, const char *mesg)
+{
+    if (obj->where != wheretype)
+        insane_object(obj, ofmt0, mesg, (struct monst *) 0);
+    if (obj->where == OBJ_INVENT && obj->how_lost != LOST_NONE) {
+        char lostbuf[40];
+        Sprintf(lostbuf, "how_lost=%d obj in inventory!", obj->how_lost);
+        insane_object(obj, ofmt0, lostbuf, (struct monst *) 0);
+    }
+    if (Has_contents(obj)) {
+        if (wheretype == OBJ_ONBILL)
+            /* containers on shop bill should always be empty */
+            insane_object(obj, "%s obj contains something! %s %s: %s",
+                          mesg, (struct monst *) 0);
+        check_contained(obj, mesg);
+    }
+    if (obj->unpaid || obj->no_charge) {
+        shop_obj_sanity(obj, mesg);
+    }
+    if (obj->owornmask) {
+        char maskbuf[40];
+        boolean bc_ok = FALSE;
+
+        switch (obj->where) {
+        case OBJ_INVENT:
+        case OBJ_MINVENT:
+            sanity_check_worn(obj);
+            break;
+        case OBJ_MIGRATING:
+            /* migrating objects overload the owornmask field
+               with a destination code; skip attempt to check it */
+            break;
+        case OBJ_FLOOR:
+            /* note: ball and chain can also be OBJ_FREE, but not across
+               turns so this sanity check shouldn't encounter that */
+            bc_ok = TRUE;
+        /*FALLTHRU*/
+        default:
+            if ((obj != uchain && obj != uball) || !bc_ok) {
+                /* discovered an object not in inventory which
+                   erroneously has worn mask set */
+                Sprintf(maskbuf, "worn mask 0x%08lx", obj->owornmask);
+                insane_object(obj, ofmt0, maskbuf, (struct monst *) 0);
             }
+            break;
         }
-        if (obj->globby)
-            check_glob(obj, mesg);
-        /* temporary flags that might have been set but which should
-           be clear by the time this sanity check is taking place */
-        if (obj->in_use || obj->bypass || obj->nomerge
-            || (obj->otyp == BOULDER && obj->next_boulder))
-            insane_obj_bits(obj, (struct monst *) 0);
     }
+    if (obj->globby)
+        check_glob(obj, mesg);
+    /* temporary flags that might have been set but which should
+       be clear by the time this sanity check is taking place */
+    if (obj->in_use || obj->bypass || obj->nomerge
+        || (obj->otyp == BOULDER && obj->next_boulder))
+        insane_obj_bits(obj, (struct monst *) 0);
 }
 
 /* check obj->unpaid and obj->no_charge for shop sanity; caller has
@@ -3046,23 +3294,29 @@ mon_obj_sanity(struct monst *monlist, const char *mesg)
             if (mwep->ocarry != mon)
                 insane_object(mwep, mfmt2, mesg, mon);
         }
-        for (obj = mon->minvent; obj; obj = obj->nobj) {
-            if (obj->where != OBJ_MINVENT)
-                insane_object(obj, mfmt1, mesg, mon);
-            if (obj->ocarry != mon)
-                insane_object(obj, mfmt2, mesg, mon);
-            if (obj->globby)
-                check_glob(obj, mesg);
-            check_contained(obj, mesg);
-            if (obj->unpaid || obj->no_charge)
-                shop_obj_sanity(obj, mesg);
-            if (obj->in_use || obj->bypass || obj->nomerge
-                || (obj->otyp == BOULDER && obj->next_boulder))
-                insane_obj_bits(obj, mon);
-        }
+        for (obj = mon->minvent; obj; obj = obj->nobj)
+            mon_invent_obj_sanity(mon, obj, mesg);
     }
 }
 
+/* sanity check for one object carried by a monster */
+staticfn void
+mon_invent_obj_sanity(struct monst *mon, struct obj *obj, const char *mesg)
+{
+    if (obj->where != OBJ_MINVENT)
+        insane_object(obj, mfmt1, mesg, mon);
+    if (obj->ocarry != mon)
+        insane_object(obj, mfmt2, mesg, mon);
+    if (obj->globby)
+        check_glob(obj, mesg);
+    check_contained(obj, mesg);
+    if (obj->unpaid || obj->no_charge)
+        shop_obj_sanity(obj, mesg);
+    if (obj->in_use || obj->bypass || obj->nomerge
+        || (obj->otyp == BOULDER && obj->next_boulder))
+        insane_obj_bits(obj, mon);
+}
+
 staticfn void
 insane_obj_bits(struct obj *obj, struct monst *mon)
 {
@@ -8,6 +8,8 @@
 #include <ctype.h>
 
 staticfn void sanity_check_single_mon(struct monst *, boolean, const char *);
+staticfn void sanity_check_fmon(struct monst *);
+staticfn void sanity_check_migr(struct monst *);
 staticfn struct obj *make_corpse(struct monst *, unsigned);
 staticfn int minliquid_core(struct monst *);
 staticfn void m_calcdistress(struct monst *);
@@ -215,68 +217,104 @@ void
 mon_sanity_check(void)
 {
     coordxy x, y;
-    struct monst *mtmp, *m;
+    struct monst *mtmp;
 
-    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
-        /* dead monsters should still have sane data */
-        sanity_check_single_mon(mtmp, TRUE, "fmon");
-        if (DEADMONSTER(mtmp) && !mtmp->isgd)
-            continue;
+    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
+        sanity_check_fmon(mtmp);
 
-        x = mtmp->mx, y = mtmp->my;
-        if (!isok(x, y) && !(mtmp->isgd && x == 0 && y == 0)) {
-            impossible("mon (%s) claims to be at <%d,%d>?",
-                       fmt_ptr((genericptr_t) mtmp), x, y);
-        } else if (mtmp == u.usteed) {
-            /* steed is in fmon list but not on the map; its
-               <mx,my> coordinates should match hero's location */
-            if (x != u.ux || y != u.uy)
-                impossible("steed (%s) claims to be at <%d,%d>?",
-                           fmt_ptr((genericptr_t) mtmp), x, y);
-        } else if (gl.level.monsters[x][y] != mtmp) {
-            impossible("mon (%s) at <%d,%d> is not there!",
+    for (x = 1; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            mon_sanity_check_at(x, y);
+
+    for (mtmp = gm.migrating_mons; mtmp; mtmp = mtmp->nmon)
+        sanity_check_migr(mtmp);
+
+    wormno_sanity_check(); /* test for bogus worm tail */
+}
+
+/* sanity checks for a monster on the fmon list */
+staticfn void
+sanity_check_fmon(struct monst *mtmp)
+{
+    coordxy x, y;
+
+    /* dead monsters should still have sane data */
+    sanity_check_single_mon(mtmp, TRUE, "fmon");
+    if (DEADMONSTER(mtmp) && !mtmp->isgd)
+        return;
+
+    x = mtmp->mx, y = mtmp->my;
+    if (!isok(x, y) && !(mtmp->isgd && x == 0 && y == 0)) {
+        impossible("mon (%s) claims to be at <%d,%d>?",
+                   fmt_ptr((genericptr_t) mtmp), x, y);
+    } else if (mtmp == u.usteed) {
+        /* steed is in fmon list but not on the map; its
+           <mx,my> coordinates should match hero's location */
+        if (x != u.ux || y != u.uy)
+            impossible("steed (%s) claims to be at <%d,%d>?",
                        fmt_ptr((genericptr_t) mtmp), x, y);
-        } else if (mtmp->wormno) {
-            sanity_check_worm(mtmp);
-
-        /* some temp mstate bits can be expected for a mon on fmon, as part of
-           removing it, but DEADMONSTER check above should skip those. */
-        } else if (mon_offmap(mtmp)) {
-            impossible("floor mon (%s) with mstate set to 0x%08lx",
-                       fmt_ptr((genericptr_t) mtmp), mtmp->mstate);
-        }
+    } else if (gl.level.monsters[x][y] != mtmp) {
+        impossible("mon (%s) at <%d,%d> is not there!",
+                   fmt_ptr((genericptr_t) mtmp), x, y);
+    } else if (mtmp->wormno) {
+        sanity_check_worm(mtmp);
+
+    /* some temp mstate bits can be expected for a mon on fmon, as part of
+       removing it, but DEADMONSTER check above should skip those. */
+    } else if (mon_offmap(mtmp)) {
+        impossible("floor mon (%s) with mstate set to 0x%08lx",
+                   fmt_ptr((genericptr_t) mtmp), mtmp->mstate);
     }
+}
 
-    for (x = 1; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            if ((mtmp = gl.level.monsters[x][y]) != 0) {
-                for (m = fmon; m; m = m->nmon)
-                    if (m == mtmp)
-                        break;
-                if (!m)
-                    impossible("map mon (%s) at <%d,%d> not in fmon list!",
-                               fmt_ptr((genericptr_t) mtmp), x, y);
-                else if (mtmp == u.usteed)
-                    impossible("steed (%s) is on the map at <%d,%d>!",
-                               fmt_ptr((genericptr_t) mtmp), x, y);
-                else if ((mtmp->mx != x || mtmp->my != y)
-                         && mtmp->data != &mons[PM_LONG_WORM])
-                    impossible("map mon (%s) at <%d,%d> is found at <%d,%d>?",
-                               fmt_ptr((genericptr_t) mtmp),
-                               mtmp->mx, mtmp->my, x, y);
-            }
+/* sanity checks for a monster on the migrating_mons list */
+staticfn void
+sanity_check_migr(struct monst *mtmp)
+{
+    sanity_check_single_mon(mtmp, FALSE, "migr");
+
+    if ((mtmp->mstate
+         & ~(MON_MIGRATING | MON_LIMBO | MON_ENDGAME_MIGR | MON_OFFMAP)) != 0L
+        || !(mtmp->mstate & MON_MIGRATING))
+        impossible("migrating mon (%s) with mstate set to 0x%08lx",
+                   fmt_ptr((genericptr_t) mtmp), mtmp->mstate);
+}
 
-    for (mtmp = gm.migrating_mons; mtmp; mtmp = mtmp->nmon) {
-        sanity_check_single_mon(mtmp, FALSE, "migr");
+/* check the map's record of monsters at one location */
+void
+mon_sanity_check_at(coordxy x, coordxy y)
+{
+    struct monst *mtmp, *m;
 
-        if ((mtmp->mstate
-             & ~(MON_MIGRATING | MON_LIMBO | MON_ENDGAME_MIGR | MON_OFFMAP)) != 0L
-            || !(mtmp->mstate & MON_MIGRATING))
-            impossible("migrating mon (%s) with mstate set to 0x%08lx",
-                       fmt_ptr((genericptr_t) mtmp), mtmp->mstate);
+    if ((mtmp = gl.level.monsters[x][y]) != 0) {
+        for (m = fmon; m; m = m->nmon)
+            if (m == mtmp)
+                break;
+        if (!m)
+            impossible("map mon (%s) at <%d,%d> not in fmon list!",
+                       fmt_ptr((genericptr_t) mtmp), x, y);
+        else if (mtmp == u.usteed)
+            impossible("steed (%s) is on the map at <%d,%d>!",
+                       fmt_ptr((genericptr_t) mtmp), x, y);
+        else if ((mtmp->mx != x || mtmp->my != y)
+                 && mtmp->data != &mons[PM_LONG_WORM])
+            impossible("map mon (%s) at <%d,%d> is found at <%d,%d>?",
+                       fmt_ptr((genericptr_t) mtmp),
+                       mtmp->mx, mtmp->my, x, y);
     }
+}
 
-    wormno_sanity_check(); /* test for bogus worm tail */
+/* check a single monster which has been touched since the last pass of
+   incremental sanity checking */
+void
+mon_sanity_check_one(struct monst *mtmp)
+{
+    if ((mtmp->mstate & MON_MIGRATING) != 0L)
+        sanity_check_migr(mtmp);
+    else if (mtmp->mstate == MON_FLOOR || DEADMONSTER(mtmp))
+        sanity_check_fmon(mtmp);
+    /* else in transit (mydogs or limbo) between turns; obj_sanity_check()
+       complains about a non-empty mydogs list when doing a full pass */
 }
 
 /* Would monster be OK with poison gas? */
@@ -2402,7 +2440,7 @@ dealloc_mextra(struct monst *m)
             free((genericptr_t) x->edog), x->edog = 0;
         x->mcorpsenm = NON_PM; /* no allocation to release */
 
-        free((genericptr_t) x);
+        nhpool_put(&mextra_pool, (genericptr_t) x);
         m->mextra = (struct mextra *) 0;
     }
 }
@@ -2419,10 +2457,11 @@ dealloc_monst(struct monst *mon)
     }
     if (mon->mextra)
         dealloc_mextra(mon);
+    sanity_forget_mon(mon);
     /* clear out of date information contained in the about-to-become
        stale memory; see dealloc_obj() */
     *mon = cg.zeromonst;
-    free((genericptr_t) mon);
+    nhpool_put(&monst_pool, (genericptr_t) mon);
 }
 
 /* 'mon' is being removed from level due to migration [relmon from keepdogs
@@ -2462,6 +2501,7 @@ mon_leaving_level(struct monst *mon)
     /* if mon is a remembered target, forget it since it isn't here anymore */
     if (mon == gc.context.polearm.hitmon)
         gc.context.polearm.hitmon = (struct monst *) 0;
+    sanity_touch_mon(mon);
 }
 
 /* 'mtmp' is going away; remove effects of mtmp from other data structures */
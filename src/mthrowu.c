@@ -1206,6 +1206,8 @@ m_carrying(struct monst *mtmp, int type)
 {
     struct obj *otmp;
 
+    if (!m_might_carry(mtmp, type))
+        return (struct obj *) 0;
     for (otmp = (mtmp == &gy.youmonst) ? gi.invent : mtmp->minvent; otmp;
          otmp = otmp->nobj)
         if (otmp->otyp == type)
@@ -1213,6 +1215,38 @@ m_carrying(struct monst *mtmp, int type)
     return otmp;
 }
 
+/* return mon's inventory summary, rebuilding it first if its inventory
+   has changed since it was last used; &gy.youmonst summarizes invent */
+struct minvsum *
+m_invsum(struct monst *mon)
+{
+    struct minvsum *sum = &mon->minvsum;
+    struct obj *otmp;
+
+    if (!sum->valid) {
+        sum->otyps = (uint64) 0;
+        sum->classes = (uint32) 0;
+        for (otmp = (mon == &gy.youmonst) ? gi.invent : mon->minvent; otmp;
+             otmp = otmp->nobj) {
+            sum->otyps |= minvsum_bit(otmp->otyp);
+            sum->classes |= 1U << otmp->oclass;
+        }
+        sum->valid = TRUE;
+    }
+    return sum;
+}
+
+/* obj's type has been changed in place; whoever is carrying it needs to
+   have their inventory summary rebuilt */
+void
+obj_retyped(struct obj *obj)
+{
+    if (carried(obj))
+        minvent_changed(&gy.youmonst);
+    else if (mcarried(obj))
+        minvent_changed(obj->ocarry);
+}
+
 void
 hit_bars(
     struct obj **objp,    /* *objp will be set to NULL if object breaks */
@@ -427,6 +427,13 @@ m_next2m(struct monst *mtmp)
 boolean
 find_defensive(struct monst *mtmp, boolean tryescape)
 {
+    /* items considered by the final inventory loop */
+    static const uint64 defensive_otyps =
+        minvsum_bit(WAN_DIGGING) | minvsum_bit(WAN_TELEPORTATION)
+        | minvsum_bit(SCR_TELEPORTATION) | minvsum_bit(POT_FULL_HEALING)
+        | minvsum_bit(POT_EXTRA_HEALING) | minvsum_bit(POT_HEALING)
+        | minvsum_bit(POT_SICKNESS) | minvsum_bit(WAN_CREATE_MONSTER)
+        | minvsum_bit(SCR_CREATE_MONSTER);
     struct obj *obj;
     struct trap *t;
     int fraction;
@@ -461,7 +468,7 @@ find_defensive(struct monst *mtmp, boolean tryescape)
      */
     if (mtmp->mconf || mtmp->mstun || !mtmp->mcansee) {
         obj = 0;
-        if (!nohands(mtmp->data)) {
+        if (!nohands(mtmp->data) && m_might_carry(mtmp, UNICORN_HORN)) {
             for (obj = mtmp->minvent; obj; obj = obj->nobj)
                 if (obj->otyp == UNICORN_HORN && !obj->cursed)
                     break;
@@ -473,7 +480,8 @@ find_defensive(struct monst *mtmp, boolean tryescape)
         }
     }
 
-    if (mtmp->mconf || mtmp->mstun) {
+    if ((mtmp->mconf || mtmp->mstun)
+        && (m_might_carry(mtmp, CORPSE) || m_might_carry(mtmp, TIN))) {
         struct obj *liztin = 0;
 
         for (obj = mtmp->minvent; obj; obj = obj->nobj) {
@@ -515,7 +523,9 @@ find_defensive(struct monst *mtmp, boolean tryescape)
         && uwep && uwep->otyp == CORPSE
         && touch_petrifies(&mons[uwep->corpsenm])
         && !poly_when_stoned(mtmp->data) && !resists_ston(mtmp)
-        && lined_up(mtmp)) { /* only lines up if distu range is within 5*5 */
+        && lined_up(mtmp) /* only lines up if distu range is within 5*5 */
+        /* after lined_up(), which can use up a random number */
+        && m_might_carry(mtmp, WAN_UNDEAD_TURNING)) {
         /* could use m_carrying(), then nxtobj() when matching wand
            is empty, but direct traversal is actually simpler here */
         for (obj = mtmp->minvent; obj; obj = obj->nobj)
@@ -638,6 +648,11 @@ find_defensive(struct monst *mtmp, boolean tryescape)
               || t->ttyp == BEAR_TRAP))
         t = 0; /* ok for monster to dig here */
 
+    /* has_defense is still 0 here, so the loop below wouldn't call rn2()
+       before finding one of these; skipping it leaves the RNG alone */
+    if (!(m_invsum(mtmp)->otyps & defensive_otyps))
+        goto botm;
+
 #define nomore(x)       if (gm.m.has_defense == x) continue;
     /* selection could be improved by collecting all possibilities
        into an array and then picking one at random */
@@ -1349,6 +1364,18 @@ mon_has_friends(struct monst *mtmp)
 boolean
 find_offensive(struct monst *mtmp)
 {
+    /* items considered by the inventory loop */
+    static const uint64 offensive_otyps =
+        minvsum_bit(WAN_DEATH) | minvsum_bit(WAN_SLEEP)
+        | minvsum_bit(WAN_FIRE) | minvsum_bit(FIRE_HORN)
+        | minvsum_bit(WAN_COLD) | minvsum_bit(FROST_HORN)
+        | minvsum_bit(WAN_LIGHTNING) | minvsum_bit(WAN_MAGIC_MISSILE)
+        | minvsum_bit(WAN_UNDEAD_TURNING) | minvsum_bit(WAN_STRIKING)
+        | minvsum_bit(WAN_TELEPORTATION) | minvsum_bit(POT_PARALYSIS)
+        | minvsum_bit(POT_BLINDNESS) | minvsum_bit(POT_CONFUSION)
+        | minvsum_bit(POT_SLEEPING) | minvsum_bit(POT_ACID)
+        | minvsum_bit(SCR_EARTH) | minvsum_bit(EXPENSIVE_CAMERA)
+        | minvsum_bit(SCR_FIRE);
     struct obj *obj;
     boolean reflection_skip = m_seenres(mtmp, M_SEEN_REFL) != 0
         || monnear(mtmp, mtmp->mux, mtmp->muy);
@@ -1370,6 +1397,8 @@ find_offensive(struct monst *mtmp)
     /* all offensive items require orthogonal or diagonal targeting */
     if (!lined_up(mtmp))
         return FALSE;
+    if (!(m_invsum(mtmp)->otyps & offensive_otyps))
+        return FALSE;
 
 #define nomore(x)       if (gm.m.has_offense == x) continue;
     /* this picks the last viable item rather than prioritizing choices */
@@ -2001,6 +2030,16 @@ rnd_offensive_item(struct monst *mtmp)
 boolean
 find_misc(struct monst *mtmp)
 {
+    /* items considered by the inventory loop */
+    static const uint64 misc_otyps =
+        minvsum_bit(POT_GAIN_LEVEL) | minvsum_bit(BULLWHIP)
+        | minvsum_bit(WAN_MAKE_INVISIBLE) | minvsum_bit(POT_INVISIBILITY)
+        | minvsum_bit(WAN_SPEED_MONSTER) | minvsum_bit(POT_SPEED)
+        | minvsum_bit(WAN_POLYMORPH) | minvsum_bit(POT_POLYMORPH)
+        /* Is_container() */
+        | minvsum_bit(LARGE_BOX) | minvsum_bit(CHEST) | minvsum_bit(ICE_BOX)
+        | minvsum_bit(SACK) | minvsum_bit(OILSKIN_SACK)
+        | minvsum_bit(BAG_OF_HOLDING);
     struct obj *obj;
     struct permonst *mdat = mtmp->data;
     coordxy x = mtmp->mx, y = mtmp->my;
@@ -2047,7 +2086,7 @@ find_misc(struct monst *mtmp)
                         }
                     }
     }
-    if (nohands(mdat))
+    if (nohands(mdat) || !(m_invsum(mtmp)->otyps & misc_otyps))
         return 0;
 
     /* normally we would want to bracket a macro expansion containing
@@ -2670,9 +2709,13 @@ DISABLE_WARNING_FORMAT_NONLITERAL
 boolean
 mon_reflects(struct monst *mon, const char *str)
 {
-    struct obj *orefl = which_armor(mon, W_ARMS);
+    struct obj *orefl;
+    /* skip the which_armor() inventory walks for things it isn't carrying */
+    uint64 carried = m_invsum(mon)->otyps;
 
-    if (orefl && orefl->otyp == SHIELD_OF_REFLECTION) {
+    if ((carried & minvsum_bit(SHIELD_OF_REFLECTION))
+        && (orefl = which_armor(mon, W_ARMS)) != 0
+        && orefl->otyp == SHIELD_OF_REFLECTION) {
         if (str) {
             pline(str, s_suffix(mon_nam(mon)), "shield");
             makeknown(SHIELD_OF_REFLECTION);
@@ -2683,14 +2726,17 @@ mon_reflects(struct monst *mon, const char *str)
         if (str)
             pline(str, s_suffix(mon_nam(mon)), "weapon");
         return TRUE;
-    } else if ((orefl = which_armor(mon, W_AMUL))
+    } else if ((carried & minvsum_bit(AMULET_OF_REFLECTION))
+               && (orefl = which_armor(mon, W_AMUL)) != 0
                && orefl->otyp == AMULET_OF_REFLECTION) {
         if (str) {
             pline(str, s_suffix(mon_nam(mon)), "amulet");
             makeknown(AMULET_OF_REFLECTION);
         }
         return TRUE;
-    } else if ((orefl = which_armor(mon, W_ARM))
+    } else if ((carried & (minvsum_bit(SILVER_DRAGON_SCALES)
+                           | minvsum_bit(SILVER_DRAGON_SCALE_MAIL)))
+               && (orefl = which_armor(mon, W_ARM)) != 0
                && (orefl->otyp == SILVER_DRAGON_SCALES
                    || orefl->otyp == SILVER_DRAGON_SCALE_MAIL)) {
         if (str)
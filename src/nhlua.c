@@ -43,6 +43,7 @@ staticfn int nhl_callback(lua_State *);
 staticfn int nhl_gamestate(lua_State *);
 staticfn int nhl_test(lua_State *);
 staticfn int nhl_getmap(lua_State *);
+staticfn int nhl_getmapcells(lua_State *);
 staticfn char splev_typ2chr(schar);
 staticfn int nhl_gettrap(lua_State *);
 staticfn int nhl_deltrap(lua_State *);
@@ -83,6 +84,7 @@ staticfn void *nhl_alloc(void *, void *, size_t, size_t);
 staticfn lua_State *nhlL_newstate (nhl_sandbox_info *, const char *);
 staticfn void end_luapat(void);
 staticfn int nhl_get_config(lua_State *);
+staticfn int nhl_regex_match(lua_State *);
 staticfn int nhl_variable(lua_State *);
 staticfn void nhl_clearfromtable(lua_State *, int, int, struct e *);
 staticfn void nhl_warn(void *, const char *, int);
@@ -604,6 +606,87 @@ nhl_getmap(lua_State *L)
     }
 }
 
+/* arrays in the table returned by nh.getmapcells() */
+static const char *const mapcell_fields[] = {
+    "glyph", "typ", "seenv", "flags", "trap", "lit", "monster", "object"
+};
+
+/* local m = nh.getmapcells(); */
+/* local m = nh.getmapcells(x1, y1, x2, y2); */
+/* local m = nh.getmapcells({ x1 = 1, y1 = 1, x2 = 10, y2 = 5 }); */
+staticfn int
+nhl_getmapcells(lua_State *L)
+{
+    static struct map_cell cells[COLNO * ROWNO];
+    int argc = lua_gettop(L);
+    coordxy x1 = 1, y1 = 0, x2 = COLNO - 1, y2 = ROWNO - 1;
+    int f, i, n;
+
+    if (argc == 4) {
+        x1 = (coordxy) luaL_checkinteger(L, 1);
+        y1 = (coordxy) luaL_checkinteger(L, 2);
+        x2 = (coordxy) luaL_checkinteger(L, 3);
+        y2 = (coordxy) luaL_checkinteger(L, 4);
+    } else if (argc == 1 && lua_type(L, 1) == LUA_TTABLE) {
+        x1 = (coordxy) get_table_int(L, "x1");
+        y1 = (coordxy) get_table_int(L, "y1");
+        x2 = (coordxy) get_table_int(L, "x2");
+        y2 = (coordxy) get_table_int(L, "y2");
+    } else if (argc != 0) {
+        nhl_error(L, "Incorrect arguments");
+        return 0;
+    }
+    if (argc) {
+        cvt_to_abscoord(&x1, &y1);
+        cvt_to_abscoord(&x2, &y2);
+    }
+    if ((n = map_snapshot(cells, x1, y1, x2, y2)) < 0) {
+        nhl_error(L, "Coordinates out of range");
+        return 0;
+    }
+
+    lua_createtable(L, 0, 4 + SIZE(mapcell_fields));
+    nhl_add_table_entry_int(L, "x", x1);
+    nhl_add_table_entry_int(L, "y", y1);
+    nhl_add_table_entry_int(L, "width", x2 - x1 + 1);
+    nhl_add_table_entry_int(L, "height", y2 - y1 + 1);
+    for (f = 0; f < SIZE(mapcell_fields); ++f) {
+        lua_pushstring(L, mapcell_fields[f]);
+        lua_createtable(L, n, 0);
+        for (i = 0; i < n; ++i) {
+            switch (f) {
+            case 0:
+                lua_pushinteger(L, cells[i].glyph);
+                break;
+            case 1:
+                lua_pushinteger(L, cells[i].typ);
+                break;
+            case 2:
+                lua_pushinteger(L, cells[i].seenv);
+                break;
+            case 3:
+                lua_pushinteger(L, cells[i].flags);
+                break;
+            case 4:
+                lua_pushinteger(L, cells[i].ttyp);
+                break;
+            case 5:
+                lua_pushboolean(L, (cells[i].bits & MAPCELL_LIT) != 0);
+                break;
+            case 6:
+                lua_pushboolean(L, (cells[i].bits & MAPCELL_MONSTER) != 0);
+                break;
+            default:
+                lua_pushboolean(L, (cells[i].bits & MAPCELL_OBJECT) != 0);
+                break;
+            }
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_rawset(L, -3);
+    }
+    return 1;
+}
+
 /* impossible("Error!") */
 staticfn int
 nhl_impossible(lua_State *L)
@@ -677,6 +760,34 @@ nhl_get_config(lua_State *L)
     return 0;
 }
 
+/* test a string against a regular expression the way MSGTYPE,
+   MENUCOLOR and autopickup exceptions do */
+/* local matched = regex_match("\\<foo\\>", "a foo b"); */
+staticfn int
+nhl_regex_match(lua_State *L)
+{
+    int argc = lua_gettop(L);
+
+    if (argc == 2) {
+        const char *pat = luaL_checkstring(L, 1),
+                   *str = luaL_checkstring(L, 2);
+        struct nhregex *re = regex_init();
+        char errbuf[BUFSZ];
+
+        if (!regex_compile(pat, re)) {
+            Snprintf(errbuf, sizeof errbuf, "Bad regex \"%s\"", pat);
+            regex_free(re);
+            nhl_error(L, errbuf);
+        }
+        lua_pushboolean(L, regex_match(str, re));
+        regex_free(re);
+        return 1;
+    } else
+        nhl_error(L, "Wrong args");
+
+    return 0;
+}
+
 /*
   str = getlin("What do you want to call this dungeon level?");
  */
@@ -1690,6 +1801,7 @@ static const struct luaL_Reg nhl_functions[] = {
     { "test", nhl_test },
 
     { "getmap", nhl_getmap },
+    { "getmapcells", nhl_getmapcells },
 #if 0
     { "setmap", nhl_setmap },
 #endif
@@ -1724,6 +1836,7 @@ static const struct luaL_Reg nhl_functions[] = {
     { "parse_config", nhl_parse_config },
     { "get_config", nhl_get_config },
     { "get_config_errors", l_get_config_errors },
+    { "regex_match", nhl_regex_match },
 #ifdef DUMPLOG
     { "dump_fmtstr", nhl_dump_fmtstr },
 #endif /* DUMPLOG */
@@ -2016,6 +2129,7 @@ nhl_loadlua(lua_State *L, const char *fname)
     boolean ret = TRUE;
     dlb *fh;
     char *buf = (char *) 0, *bufin, *bufout, *p, *nl, *altfname;
+    const char *map;
     long buflen, ct, cnt;
     int llret;
 
@@ -2031,6 +2145,15 @@ nhl_loadlua(lua_State *L, const char *fname)
         goto give_up;
     }
 
+    /* when the file is in a library mapped into memory, lua can parse
+       it right there unless it has CRLF line ends to strip */
+    if ((map = dlb_fmap(fh, &buflen)) != 0
+        && !memchr(map, '\r', (size_t) buflen)) {
+        llret = luaL_loadbuffer(L, map, (size_t) buflen, altfname);
+        (void) dlb_fclose(fh);
+        goto loaded;
+    }
+
     dlb_fseek(fh, 0L, SEEK_END);
     buflen = dlb_ftell(fh);
     dlb_fseek(fh, 0L, SEEK_SET);
@@ -2097,6 +2220,7 @@ nhl_loadlua(lua_State *L, const char *fname)
     (void) dlb_fclose(fh);
 
     llret = luaL_loadbuffer(L, buf, strlen(buf), altfname);
+ loaded:
     if (llret != LUA_OK) {
         impossible("luaL_loadbuffer: Error loading %s: %s", altfname,
                    lua_tostring(L, -1));
@@ -3731,7 +3731,8 @@ wizterrainwish(struct _readobjnam_data *d)
         madeterrain = TRUE;
         lev->typ = wall;
         fix_wall_spines(max(0,u.ux-1), max(0,u.uy-1),
-                        min(COLNO,u.ux+1), min(ROWNO,u.uy+1));
+                        min(COLNO-1,u.ux+1), min(ROWNO-1,u.uy+1));
+        set_wall_state_area(u.ux - 1, u.uy - 1, u.ux + 1, u.uy + 1);
         pline("A wall.");
     } else if (!BSTRCMPI(bp, p - 15, "secret corridor")) {
         if (lev->typ == CORR) {
@@ -127,6 +127,11 @@ static boolean give_opt_msg = TRUE;
 
 enum { MAX_ROLEOPT = 4 };  /* 4: role,race,gend,algn */
 static boolean opt_set_in_config[OPTCOUNT];
+/* allopt[] indices grouped by the first letter of the option name (in
+   allopt[] order within each group) and where each group starts; lets
+   parseoptions() skip the options that can't possibly match */
+static short optname_order[OPTCOUNT];
+static short optname_first[256 + 1];
 static char *roleoptvals[MAX_ROLEOPT][num_opt_phases];
 
 static NEARDATA const char *OptS_type[OptS_Advanced+1] = {
@@ -327,6 +332,7 @@ staticfn int feature_alert_opts(char *, const char *);
 staticfn boolean duplicate_opt_detection(int);
 staticfn void complain_about_duplicate(int);
 staticfn int length_without_val(const char *, int len);
+staticfn int QSORTCALLBACK optname_cmp(const genericptr, const genericptr);
 staticfn void determine_ambiguities(void);
 staticfn int check_misc_menu_command(char *, char *);
 staticfn int opt2roleopt(int);
@@ -466,7 +472,8 @@ parseoptions(
 #if 0
     boolean has_val = FALSE;
 #endif
-    int i, matchidx = -1, optresult = optn_err, optlen, optlen_wo_val;
+    int i, k, kend, matchidx = -1, optresult = optn_err, optlen,
+        optlen_wo_val;
     boolean retval = TRUE;
 
     duplicate = FALSE;
@@ -513,7 +520,12 @@ parseoptions(
 #endif
     }
 
-    for (i = 0; i < OPTCOUNT; ++i) {
+    /* every option name that could match starts with the same letter
+       as opts; an empty name (just "no" or ":val") gets the full list */
+    k = optlen ? optname_first[(uchar) lowc(*opts)] : 0;
+    kend = optlen ? optname_first[(uchar) lowc(*opts) + 1] : OPTCOUNT;
+    for (; k < kend; ++k) {
+        i = optlen ? optname_order[k] : k;
         got_match = FALSE;
 
         if (allopt[i].pfx) {
@@ -3523,6 +3535,76 @@ optfn_runmode(
     return optn_ok;
 }
 
+staticfn int
+optfn_sanity_check_budget(
+    int optidx, int req, boolean negated,
+    char *opts, char *op)
+{
+    if (req == do_init) {
+        return optn_ok;
+    }
+    if (req == do_set) {
+        /* sanity_check_budget:nn; 0 or !sanity_check_budget to check
+           everything every turn */
+        op = string_for_opt(opts, negated);
+        if ((negated && op == empty_optstr)
+            || (!negated && op != empty_optstr)) {
+            int val = negated ? 0 : atoi(op);
+
+            if (val < 0) {
+                config_error_add("%s: value must not be negative",
+                                 allopt[optidx].name);
+                return optn_err;
+            }
+            iflags.sanity_budget = val;
+        } else if (negated) {
+            bad_negation(allopt[optidx].name, TRUE);
+            return optn_err;
+        }
+        return optn_ok;
+    }
+    if (req == get_val || req == get_cnf_val) {
+        Sprintf(opts, "%d", iflags.sanity_budget);
+        return optn_ok;
+    }
+    return optn_ok;
+}
+
+staticfn int
+optfn_sanity_check_interval(
+    int optidx, int req, boolean negated,
+    char *opts, char *op)
+{
+    if (req == do_init) {
+        return optn_ok;
+    }
+    if (req == do_set) {
+        /* sanity_check_interval:nn; 0 or !sanity_check_interval to only
+           do a full check when the incremental one can't keep up */
+        op = string_for_opt(opts, negated);
+        if ((negated && op == empty_optstr)
+            || (!negated && op != empty_optstr)) {
+            int val = negated ? 0 : atoi(op);
+
+            if (val < 0) {
+                config_error_add("%s: value must not be negative",
+                                 allopt[optidx].name);
+                return optn_err;
+            }
+            iflags.sanity_interval = val;
+        } else if (negated) {
+            bad_negation(allopt[optidx].name, TRUE);
+            return optn_err;
+        }
+        return optn_ok;
+    }
+    if (req == get_val || req == get_cnf_val) {
+        Sprintf(opts, "%d", iflags.sanity_interval);
+        return optn_ok;
+    }
+    return optn_ok;
+}
+
 staticfn int
 optfn_scores(
     int optidx, int req, boolean negated,
@@ -6464,40 +6546,65 @@ bad_negation(const char *optname, boolean with_parameter)
 /* go through all of the options and set the minmatch value
    based on what is needed for uniqueness of each individual
    option. Set a minimum of 3 characters. */
+/* qsort callback routine for sorting option indices by name */
+staticfn int QSORTCALLBACK
+optname_cmp(const genericptr vptr1, const genericptr vptr2)
+{
+    int indx1 = *(int *) vptr1, indx2 = *(int *) vptr2;
+
+    return strcmpi(allopt[indx1].name, allopt[indx2].name);
+}
+
 staticfn void
 determine_ambiguities(void)
 {
-    int i, j, len, tmpneeded, needed[SIZE(allopt)];
+    int i, j, k, len, tmpneeded, needed[OPTCOUNT], sorted[OPTCOUNT];
     const char *p1, *p2;
 
-    for (i = 0; i < SIZE(allopt) - 1; ++i) {
+    for (i = 0; i < OPTCOUNT; ++i) {
         needed[i] = 0;
+        sorted[i] = i;
+    }
+
+    /* once the names are sorted, the longest prefix that one of them
+       shares with any other is the one shared with a neighbor */
+    qsort((genericptr_t) sorted, OPTCOUNT, sizeof (int), optname_cmp);
+    for (k = 1; k < OPTCOUNT; ++k) {
+        i = sorted[k - 1];
+        j = sorted[k];
+        p1 = allopt[i].name;
+        p2 = allopt[j].name;
+        tmpneeded = 1;
+        while (*p1 && *p2 && lowc(*p1) == lowc(*p2)) {
+            ++tmpneeded;
+            ++p1;
+            ++p2;
+        }
+        if (tmpneeded > needed[i])
+            needed[i] = tmpneeded;
+        if (tmpneeded > needed[j])
+            needed[j] = tmpneeded;
     }
-
-    for (i = 0; i < SIZE(allopt) - 1; ++i) {
-        for (j = 0; j < SIZE(allopt) - 1; ++j) {
-            if (j == i)
-                continue;
-
-            p1 = allopt[i].name; /* back to the start */
-            p2 = allopt[j].name;
-            tmpneeded = 1;
-            while (*p1 && *p2 && lowc(*p1) == lowc(*p2)) {
-                ++tmpneeded;
-                ++p1;
-                ++p2;
-            }
-            if (tmpneeded > needed[i])
-                needed[i] = tmpneeded;
-            if (tmpneeded > needed[j])
-                needed[j] = tmpneeded;
-        }
-    }
-    for (i = 0; i < SIZE(allopt) - 1; ++i) {
+    for (i = 0; i < OPTCOUNT; ++i) {
         len = Strlen(allopt[i].name);
         allopt[i].minmatch = (needed[i] < 3) ? 3
                                 : (needed[i] <= len) ? needed[i] : len;
     }
+
+    /* group the options by first letter for parseoptions() */
+    (void) memset((genericptr_t) optname_first, 0, sizeof optname_first);
+    for (i = 0; i < OPTCOUNT; ++i)
+        ++optname_first[(uchar) lowc(*allopt[i].name) + 1];
+    for (k = 1; k <= 256; ++k)
+        optname_first[k] += optname_first[k - 1];
+    for (i = 0; i < OPTCOUNT; ++i) {
+        k = (uchar) lowc(*allopt[i].name);
+        optname_order[optname_first[k]++] = (short) i;
+    }
+    /* the filling pass advanced each start to the next group's start */
+    for (k = 256; k > 0; --k)
+        optname_first[k] = optname_first[k - 1];
+    optname_first[0] = 0;
 }
 
 staticfn int
@@ -6950,6 +7057,8 @@ initoptions_init(void)
     flags.pile_limit = PILE_LIMIT_DFLT;  /* 5 */
     flags.runmode = RUN_LEAP;
     iflags.msg_history = 20;
+    iflags.sanity_budget = 0; /* full sanity_check every turn */
+    iflags.sanity_interval = 100;
     /* msg_window has conflicting defaults for multi-interface binary */
 #ifdef TTY_GRAPHICS
     iflags.prevmsg_window = 's';
@@ -7504,6 +7613,62 @@ query_msgtype(void)
     return -1;
 }
 
+static struct regex_cache msgtype_cache, ape_cache;
+
+/* forget all the strings remembered by 'rc' */
+void
+regex_cache_clear(struct regex_cache *rc)
+{
+    int i;
+
+    for (i = 0; i < REGEX_CACHE_SIZE; ++i)
+        rc->ent[i].used = FALSE;
+    rc->list = (genericptr_t) 0;
+    rc->next = 0;
+}
+
+/* look for 'str' among the strings checked against the rule list which
+   starts with 'list'; if found, set '*rule' to the rule it matched */
+boolean
+regex_cache_find(
+    struct regex_cache *rc,
+    genericptr_t list,
+    const char *str,
+    genericptr_t *rule)
+{
+    int i;
+
+    /* adding a rule changes the start of the list; removing one other
+       than the first is expected to clear the cache */
+    if (rc->list != list) {
+        regex_cache_clear(rc);
+        rc->list = list;
+        return FALSE;
+    }
+    for (i = 0; i < REGEX_CACHE_SIZE; ++i)
+        if (rc->ent[i].used && !strcmp(rc->ent[i].str, str)) {
+            *rule = rc->ent[i].rule;
+            return TRUE;
+        }
+    return FALSE;
+}
+
+/* remember that 'str' matched 'rule' (Null for none); only valid right
+   after regex_cache_find() with the same 'str' has failed */
+void
+regex_cache_add(struct regex_cache *rc, const char *str, genericptr_t rule)
+{
+    struct regex_cache_ent *ent;
+
+    if (strlen(str) >= sizeof ent->str)
+        return;
+    ent = &rc->ent[rc->next];
+    rc->next = (rc->next + 1) % REGEX_CACHE_SIZE;
+    Strcpy(ent->str, str);
+    ent->rule = rule;
+    ent->used = TRUE;
+}
+
 staticfn boolean
 msgtype_add(int typ, char *pattern)
 {
@@ -7542,6 +7707,7 @@ msgtype_free(void)
         free((genericptr_t) tmp);
     }
     gp.plinemsg_types = (struct plinemsg_type *) 0;
+    regex_cache_clear(&msgtype_cache);
 }
 
 staticfn void
@@ -7550,6 +7716,7 @@ free_one_msgtype(int idx) /* 0 .. */
     struct plinemsg_type *tmp = gp.plinemsg_types;
     struct plinemsg_type *prev = NULL;
 
+    regex_cache_clear(&msgtype_cache);
     while (tmp) {
         if (idx == 0) {
             struct plinemsg_type *next = tmp->next;
@@ -7574,14 +7741,26 @@ msgtype_type(const char *msg,
              boolean norepeat) /* called from Norep(via pline) */
 {
     struct plinemsg_type *tmp = gp.plinemsg_types;
+    genericptr_t rule;
 
-    while (tmp) {
-        /* we don't exclude entries with negative msgtype values
-           because then the msg might end up matching a later pattern */
-        if (regex_match(msg, tmp->regex))
-            return tmp->msgtype;
-        tmp = tmp->next;
+    if (!tmp)
+        return norepeat ? MSGTYP_NOREP : MSGTYP_NORMAL;
+    if (regex_cache_find(&msgtype_cache, (genericptr_t) tmp, msg, &rule)) {
+        tmp = (struct plinemsg_type *) rule;
+    } else {
+        while (tmp) {
+            /* we don't exclude entries with negative msgtype values
+               because then the msg might end up matching a later
+               pattern */
+            if (regex_match(msg, tmp->regex))
+                break;
+            tmp = tmp->next;
+        }
+        regex_cache_add(&msgtype_cache, msg, (genericptr_t) tmp);
     }
+    /* msgtype is looked up afresh; hide_unhide_msgtypes() changes it */
+    if (tmp)
+        return tmp->msgtype;
     return norepeat ? MSGTYP_NOREP : MSGTYP_NORMAL;
 }
 
@@ -9094,6 +9273,7 @@ remove_autopickup_exception(struct autopickup_exception *whichape)
                 prev->next = ape;
             else
                 ga.apelist = ape;
+            regex_cache_clear(&ape_cache);
             regex_free(freeape->regex);
             free((genericptr_t) freeape->pattern);
             free((genericptr_t) freeape);
@@ -9115,6 +9295,24 @@ free_autopickup_exceptions(void)
         ga.apelist = ape->next;
         free((genericptr_t) ape);
     }
+    regex_cache_clear(&ape_cache);
+}
+
+/* first autopickup exception matching 'objdesc', or Null */
+struct autopickup_exception *
+autopickup_exception_match(const char *objdesc)
+{
+    struct autopickup_exception *ape = ga.apelist;
+    genericptr_t rule;
+
+    if (!ape)
+        return ape;
+    if (regex_cache_find(&ape_cache, (genericptr_t) ape, objdesc, &rule))
+        return (struct autopickup_exception *) rule;
+    while (ape && !regex_match(objdesc, ape->regex))
+        ape = ape->next;
+    regex_cache_add(&ape_cache, objdesc, (genericptr_t) ape);
+    return ape;
 }
 
 int
@@ -895,15 +895,9 @@ check_autopickup_exceptions(struct obj *obj)
     /*
      *  Does the text description of this match an exception?
      */
-    struct autopickup_exception *ape = ga.apelist;
-
-    if (ape) {
-        char *objdesc = makesingular(doname(obj));
-
-        while (ape && !regex_match(objdesc, ape->regex))
-            ape = ape->next;
-    }
-    return ape;
+    if (!ga.apelist)
+        return (struct autopickup_exception *) 0;
+    return autopickup_exception_match(makesingular(doname(obj)));
 }
 
 boolean
@@ -31,33 +31,23 @@ dumplogmsg(const char *line)
      *  this share it.
      */
     unsigned indx = gs.saved_pline_index; /* next slot to use */
-    char *oldest = gs.saved_plines[indx]; /* current content of that slot */
 
     if (!strncmp(line, "Unknown command", 15))
         return;
-    if (oldest && strlen(oldest) >= strlen(line)) {
-        /* this buffer will gradually shrink until the 'else' is needed;
-           there's no pressing need to track allocation size instead */
-        Strcpy(oldest, line);
-    } else {
-        if (oldest)
-            free((genericptr_t) oldest);
-        gs.saved_plines[indx] = dupstr(line);
-    }
+    /* the slots are fixed size, so reusing one never allocates */
+    copynchars(gs.saved_plines[indx], line, BUFSZ - 1);
     gs.saved_pline_index = (indx + 1) % DUMPLOG_MSG_COUNT;
 }
 
 /* called during save (unlike the interface-specific message history,
-   this data isn't saved and restored); end-of-game releases saved_plines[]
-   while writing its contents to the final dump log */
+   this data isn't saved and restored) */
 void
 dumplogfreemessages(void)
 {
     unsigned i;
 
     for (i = 0; i < DUMPLOG_MSG_COUNT; ++i)
-        if (gs.saved_plines[i])
-            free((genericptr_t) gs.saved_plines[i]), gs.saved_plines[i] = 0;
+        gs.saved_plines[i][0] = '\0';
     gs.saved_pline_index = 0;
 }
 #endif
@@ -466,25 +456,64 @@ verbalize(const char *line, ...)
     va_end(the_args);
 }
 
+/*
+ * The gamelog only ever grows until it is discarded, so its entries are
+ * kept in an array and their texts end to end in one buffer, each grown
+ * by doubling.  Adding a line is amortized O(1) with no allocation most
+ * of the time, and save and restore read and write the whole thing in
+ * bulk.
+ */
+
+/* make room for 'nlines' more entries having 'nchars' more text */
+void
+gamelog_reserve(unsigned nlines, unsigned nchars)
+{
+    unsigned want;
+
+    if (gg.gamelog_cnt + nlines > gg.gamelog_max) {
+        for (want = gg.gamelog_max ? gg.gamelog_max : 32;
+             want < gg.gamelog_cnt + nlines; want *= 2)
+            continue;
+        gg.gamelog = (struct gamelog_line *) re_alloc((long *) gg.gamelog,
+                                  want * (unsigned) sizeof *gg.gamelog);
+        gg.gamelog_max = want;
+    }
+    if (gg.gamelog_textlen + nchars > gg.gamelog_textmax) {
+        for (want = gg.gamelog_textmax ? gg.gamelog_textmax : 1024;
+             want < gg.gamelog_textlen + nchars; want *= 2)
+            continue;
+        gg.gamelog_text = (char *) re_alloc((long *) gg.gamelog_text, want);
+        gg.gamelog_textmax = want;
+    }
+}
+
+void
+gamelog_free(void)
+{
+    if (gg.gamelog)
+        free((genericptr_t) gg.gamelog), gg.gamelog = 0;
+    if (gg.gamelog_text)
+        free((genericptr_t) gg.gamelog_text), gg.gamelog_text = 0;
+    gg.gamelog_cnt = gg.gamelog_max = 0;
+    gg.gamelog_textlen = gg.gamelog_textmax = 0;
+}
+
 #ifdef CHRONICLE
 
 void
 gamelog_add(long glflags, long gltime, const char *str)
 {
-    struct gamelog_line *tmp;
-    struct gamelog_line *lst = gg.gamelog;
-
-    tmp = (struct gamelog_line *) alloc(sizeof (struct gamelog_line));
-    tmp->turn = gltime;
-    tmp->flags = glflags;
-    tmp->text = dupstr(str);
-    tmp->next = NULL;
-    while (lst && lst->next)
-        lst = lst->next;
-    if (!lst)
-        gg.gamelog = tmp;
-    else
-        lst->next = tmp;
+    struct gamelog_line *llmsg;
+    unsigned len = (unsigned) strlen(str) + 1;
+
+    gamelog_reserve(1, len);
+    llmsg = &gg.gamelog[gg.gamelog_cnt++];
+    llmsg->turn = gltime;
+    llmsg->flags = glflags;
+    llmsg->text = gg.gamelog_textlen;
+    (void) memcpy((genericptr_t) gamelog_msg(llmsg), (genericptr_t) str,
+                  len);
+    gg.gamelog_textlen += len;
 }
 
 void
@@ -639,6 +668,7 @@ execplinehandler(const char *line)
         (void) execv(args[0], (char *const *) args);
         perror((char *) 0);
         (void) fprintf(stderr, "Exec to message handler %s failed.\n", env);
+        gl.livelog_qlen = 0; /* the parent's queue, not ours to write */
         nh_terminate(EXIT_FAILURE);
     } else if (f > 0) {
         int status;
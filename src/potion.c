@@ -2517,6 +2517,7 @@ potion_dip(struct obj *obj, struct obj *potion)
             }
         }
         obj->odiluted = (obj->otyp != POT_WATER);
+        obj_retyped(obj);
 
         if (obj->otyp == POT_WATER && !Hallucination) {
             pline_The("mixture bubbles%s.", Blind ? "" : ", then clears");
@@ -2637,6 +2638,7 @@ potion_dip(struct obj *obj, struct obj *potion)
         if ((obj->otyp == MAGIC_LAMP) && obj->spe == 0) {
             obj->otyp = OIL_LAMP;
             obj->age = 0;
+            obj_retyped(obj);
         }
         if (obj->age > 1000L) {
             pline("%s %s full.", Yname2(obj), otense(obj, "are"));
@@ -2682,6 +2684,7 @@ potion_dip(struct obj *obj, struct obj *potion)
 
         costly_alteration(singlepotion, COST_NUTRLZ);
         singlepotion->otyp = mixture;
+        obj_retyped(singlepotion);
         singlepotion->blessed = 0;
         if (mixture == POT_WATER)
             singlepotion->cursed = singlepotion->odiluted = 0;
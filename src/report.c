@@ -554,7 +554,7 @@ get_saved_pline(int lineno)
     p = (gs.saved_pline_index - 1) % DUMPLOG_MSG_COUNT;
 
     while (limit--) {
-        if (gs.saved_plines[p]) { /* valid line */
+        if (*gs.saved_plines[p]) { /* valid line */
             if (lineno--) {
                 p = (p - 1 + DUMPLOG_MSG_COUNT) % DUMPLOG_MSG_COUNT;
             } else {
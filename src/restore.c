@@ -39,17 +39,9 @@ staticfn void rest_stairs(NHFILE *);
 
 /*
  * Save a mapping of IDs from ghost levels to the current level.  This
- * map is used by the timer routines when restoring ghost levels.
+ * map is used by the timer routines when restoring ghost levels.  It
+ * is kept in an id_index (see mkobj.c) keyed by ghost ID.
  */
-#define N_PER_BUCKET 64
-struct bucket {
-    struct bucket *next;
-    struct {
-        unsigned gid; /* ghost ID */
-        unsigned nid; /* new ID */
-    } map[N_PER_BUCKET];
-};
-
 staticfn void clear_id_mapping(void);
 staticfn void add_id_mapping(unsigned, unsigned);
 
@@ -412,6 +404,7 @@ restmonchn(NHFILE *nhfp)
                 mtmp->mhpmax = DEFUNCT_MONSTER;
             }
         }
+        minvent_changed(mtmp); /* summary is rebuilt on demand */
         if (mtmp->minvent) {
             struct obj *obj;
             mtmp->minvent = restobjchn(nhfp, FALSE);
@@ -626,6 +619,7 @@ restgamestate(NHFILE *nhfp)
     restore_light_sources(nhfp);
 
     gi.invent = restobjchn(nhfp, FALSE);
+    minvent_changed(&gy.youmonst);
 
     /* restore dangling (not on floor or in inventory) ball and/or chain */
     bc_obj = restobjchn(nhfp, FALSE);
@@ -740,7 +734,10 @@ dorecover(NHFILE *nhfp)
 
     get_plname_from_file(nhfp, gp.plname);
     getlev(nhfp, 0, (xint8) 0);
-    if (!restgamestate(nhfp)) {
+    PROF_START(PROF_RESTGAME);
+    rtmp = restgamestate(nhfp);
+    PROF_STOP(PROF_RESTGAME);
+    if (!rtmp) {
         NHFILE tnhfp;
 
         display_nhwindow(WIN_MESSAGE, TRUE);
@@ -1005,6 +1002,7 @@ getlev(NHFILE *nhfp, int pid, xint8 lev)
     short tlev;
 #endif
 
+    PROF_START(PROF_GETLEV);
     if (ghostly)
         clear_id_mapping();
 
@@ -1098,6 +1096,7 @@ getlev(NHFILE *nhfp, int pid, xint8 lev)
             break;
     }
     dealloc_trap(trap);
+    reindex_traps();
 
     fobj = restobjchn(nhfp, FALSE);
     find_lev_obj();
@@ -1233,6 +1232,7 @@ getlev(NHFILE *nhfp, int pid, xint8 lev)
 
     if (ghostly)
         clear_id_mapping();
+    PROF_STOP(PROF_GETLEV);
 }
 
 void
@@ -1267,24 +1267,34 @@ rest_bubbles(NHFILE *nhfp)
 staticfn void
 restore_gamelog(NHFILE *nhfp)
 {
-    int slen = 0;
-    char msg[BUFSZ*2];
-    struct gamelog_line tmp;
+    unsigned cnt = 0, textlen = 0, i;
+    struct gamelog_line *llmsg;
 
-    while (1) {
-        if (nhfp->structlevel)
-            Mread(nhfp->fd, &slen, sizeof slen);
-        if (slen == -1)
-            break;
-        if (slen > ((BUFSZ*2) - 1))
-            panic("restore_gamelog: msg too big (%d)", slen);
-        if (nhfp->structlevel) {
-            Mread(nhfp->fd, msg, slen);
-            Mread(nhfp->fd, &tmp, sizeof tmp);
-            msg[slen] = '\0';
-            gamelog_add(tmp.flags, tmp.turn, msg);
-        }
+    if (nhfp->structlevel) {
+        Mread(nhfp->fd, &cnt, sizeof cnt);
+        Mread(nhfp->fd, &textlen, sizeof textlen);
+    }
+    if (!cnt)
+        return;
+    if (!textlen || textlen > cnt * (BUFSZ * 2))
+        panic("restore_gamelog: bad size (%u entries, %u)", cnt, textlen);
+
+    /* append to anything logged before the restore */
+    gamelog_reserve(cnt, textlen);
+    llmsg = &gg.gamelog[gg.gamelog_cnt];
+    if (nhfp->structlevel) {
+        Mread(nhfp->fd, llmsg, cnt * (unsigned) sizeof *llmsg);
+        Mread(nhfp->fd, &gg.gamelog_text[gg.gamelog_textlen], textlen);
+    }
+    if (gg.gamelog_text[gg.gamelog_textlen + textlen - 1])
+        panic("restore_gamelog: unterminated text");
+    for (i = 0; i < cnt; ++i, ++llmsg) {
+        if (llmsg->text >= textlen)
+            panic("restore_gamelog: bad text offset (%u)", llmsg->text);
+        llmsg->text += gg.gamelog_textlen;
     }
+    gg.gamelog_cnt += cnt;
+    gg.gamelog_textlen += textlen;
 }
 
 staticfn void
@@ -1315,63 +1325,35 @@ restore_msghistory(NHFILE *nhfp)
 staticfn void
 clear_id_mapping(void)
 {
-    struct bucket *curr;
-
-    while ((curr = gi.id_map) != 0) {
-        gi.id_map = curr->next;
-        free((genericptr_t) curr);
-    }
-    gn.n_ids_mapped = 0;
+    id_index_free(&gi.id_map);
 }
 
-/* Add a mapping to the ID map. */
+/* Add a mapping to the ID map; a later mapping for the same ghost ID
+   replaces an earlier one. */
 staticfn void
 add_id_mapping(unsigned int gid, unsigned int nid)
 {
-    int idx;
-
-    idx = gn.n_ids_mapped % N_PER_BUCKET;
-    /* idx is zero on first time through, as well as when a new bucket is */
-    /* needed */
-    if (idx == 0) {
-        struct bucket *gnu = (struct bucket *) alloc(sizeof(struct bucket));
-        gnu->next = gi.id_map;
-        gi.id_map = gnu;
-    }
+    anything any;
 
-    gi.id_map->map[idx].gid = gid;
-    gi.id_map->map[idx].nid = nid;
-    gn.n_ids_mapped++;
+    any = cg.zeroany;
+    any.a_uint = nid;
+    id_index_add(&gi.id_map, gid, any, TRUE);
 }
 
 /*
  * Global routine to look up a mapping.  If found, return TRUE and fill
- * in the new ID value.  Otherwise, return false and return -1 in the new
- * ID.
+ * in the new ID value.  Otherwise, return false and leave the new ID
+ * alone.
  */
 boolean
 lookup_id_mapping(unsigned int gid, unsigned int *nidp)
 {
-    int i;
-    struct bucket *curr;
-
-    if (gn.n_ids_mapped)
-        for (curr = gi.id_map; curr; curr = curr->next) {
-            /* first bucket might not be totally full */
-            if (curr == gi.id_map) {
-                i = gn.n_ids_mapped % N_PER_BUCKET;
-                if (i == 0)
-                    i = N_PER_BUCKET;
-            } else
-                i = N_PER_BUCKET;
-
-            while (--i >= 0)
-                if (gid == curr->map[i].gid) {
-                    *nidp = curr->map[i].nid;
-                    return TRUE;
-                }
-        }
+    anything *a = id_index_find(&gi.id_map, gid);
 
+    if (a) {
+        *nidp = a->a_uint;
+        return TRUE;
+    }
     return FALSE;
 }
 
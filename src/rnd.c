@@ -57,6 +57,28 @@ init_isaac64(unsigned long seed, int (*fn)(int))
                  (int) sizeof seed);
 }
 
+/* the core RNG's state can be handed from one process to another;
+   used for making levels ahead of time */
+size_t
+core_rng_state_size(void)
+{
+    return sizeof rnglist[CORE].rng_state;
+}
+
+void
+get_core_rng_state(genericptr_t buf)
+{
+    (void) memcpy(buf, (genericptr_t) &rnglist[CORE].rng_state,
+                  sizeof rnglist[CORE].rng_state);
+}
+
+void
+set_core_rng_state(const genericptr_t buf)
+{
+    (void) memcpy((genericptr_t) &rnglist[CORE].rng_state, buf,
+                  sizeof rnglist[CORE].rng_state);
+}
+
 staticfn int
 RND(int x)
 {
@@ -87,6 +87,7 @@ dosave0(void)
     int res = 0;
 
     gp.program_state.saving++; /* inhibit status and perm_invent updates */
+    livelog_flush(TRUE);
     /* we may get here via hangup signal, in which case we want to fix up
        a few of things before saving so that they won't be restored in
        an improper state; these will be no-ops for normal save sequence */
@@ -241,34 +242,22 @@ dosave0(void)
 staticfn void
 save_gamelog(NHFILE *nhfp)
 {
-    struct gamelog_line *tmp = gg.gamelog, *tmp2;
-    int slen;
-
-    while (tmp) {
-        tmp2 = tmp->next;
-        if (perform_bwrite(nhfp)) {
-            if (nhfp->structlevel) {
-                slen = Strlen(tmp->text);
-                bwrite(nhfp->fd, (genericptr_t) &slen, sizeof slen);
-                bwrite(nhfp->fd, (genericptr_t) tmp->text, slen);
-                bwrite(nhfp->fd, (genericptr_t) tmp,
-                       sizeof (struct gamelog_line));
-            }
-        }
-        if (release_data(nhfp)) {
-            free((genericptr_t) tmp->text);
-            free((genericptr_t) tmp);
-        }
-        tmp = tmp2;
-    }
     if (perform_bwrite(nhfp)) {
         if (nhfp->structlevel) {
-            slen = -1;
-            bwrite(nhfp->fd, (genericptr_t) &slen, sizeof slen);
+            bwrite(nhfp->fd, (genericptr_t) &gg.gamelog_cnt,
+                   sizeof gg.gamelog_cnt);
+            bwrite(nhfp->fd, (genericptr_t) &gg.gamelog_textlen,
+                   sizeof gg.gamelog_textlen);
+            if (gg.gamelog_cnt) {
+                bwrite(nhfp->fd, (genericptr_t) gg.gamelog,
+                       gg.gamelog_cnt * (unsigned) sizeof *gg.gamelog);
+                bwrite(nhfp->fd, (genericptr_t) gg.gamelog_text,
+                       gg.gamelog_textlen);
+            }
         }
     }
     if (release_data(nhfp))
-        gg.gamelog = NULL;
+        gamelog_free();
 }
 
 staticfn void
@@ -277,6 +266,7 @@ savegamestate(NHFILE *nhfp)
     unsigned long uid;
 
     gp.program_state.saving++; /* caller should/did already set this... */
+    PROF_START(PROF_SAVEGAME);
     uid = (unsigned long) getuid();
     if (nhfp->structlevel) {
         bwrite(nhfp->fd, (genericptr_t) &uid, sizeof uid);
@@ -338,6 +328,7 @@ savegamestate(NHFILE *nhfp)
     save_luadata(nhfp);
     if (nhfp->structlevel)
         bflush(nhfp->fd);
+    PROF_STOP(PROF_SAVEGAME);
     gp.program_state.saving--;
     return;
 }
@@ -456,7 +447,9 @@ savelev(NHFILE *nhfp, xint8 lev)
         gu.uz_save = u.uz;
     }
 
+    PROF_START(PROF_SAVELEV);
     savelev_core(nhfp, lev);
+    PROF_STOP(PROF_SAVELEV);
 
     if (set_uz_save)
         gu.uz_save.dnum = gu.uz_save.dlevel = 0; /* unset */
@@ -1159,12 +1152,21 @@ freedynamicdata(void)
 
 #if defined(UNIX) && defined(MAIL)
     free_maildata();
+#endif
+#ifdef HOTPATH_PROFILING
+    prof_dump(); /* whatever has accumulated since the last interval */
+#endif
+#ifdef PREGEN_LEVELS
+    pregen_cancel();
 #endif
     zero_nhfile(&tnhfp);    /* also sets fd to -1 */
     tnhfp.mode = FREEING;
     free_menu_coloring();
     free_invbuf();           /* let_to_name (invent.c) */
     free_youbuf();           /* You_buf,&c (pline.c) */
+    if (gl.livelog_queue)    /* emptied by nh_terminate() (files.c) */
+        free((genericptr_t) gl.livelog_queue), gl.livelog_queue = 0,
+        gl.livelog_qlen = gl.livelog_qmax = 0;
     msgtype_free();
     savedsym_free();
     tmp_at(DISP_FREEMEM, 0); /* temporary display effects */
@@ -1240,6 +1242,7 @@ freedynamicdata(void)
 #endif
     discard_gamelog();
     release_runtime_info(); /* build-time options and version stuff */
+    nhpool_free_all(); /* after all objects and monsters have been freed */
 #endif /* FREE_ALL_MEMORY */
 
     if (VIA_WINDOWPORT())
@@ -1399,6 +1399,7 @@ menu_pick_pay_items(struct monst *shkp)
     win = create_nhwindow(NHW_MENU);
     start_menu(win, MENU_BEHAVE_STANDARD);
 
+    id_index_begin();
     for (n = 0; n < eshkp->billct; n++) {
         struct obj *otmp;
         struct bill_x *bp = &(eshkp->bill_p[n]);
@@ -1420,6 +1421,7 @@ menu_pick_pay_items(struct monst *shkp)
                      MENU_ITEMFLAGS_NONE);
         }
     }
+    id_index_end();
 
     end_menu(win, "Pay for which items?");
     n = select_menu(win, PICK_ANY, &pick_list);
@@ -2231,8 +2233,15 @@ find_oid(unsigned int id)
 {
     struct obj *obj;
     struct monst *mon, *mmtmp[3];
+    anything *idp;
     int i;
 
+    /* when a caller is doing many lookups, use the index they set up */
+    if (gi.id_index_depth && id) {
+        idp = id_index_find(&gi.oid_index, id);
+        return idp ? idp->a_obj : (struct obj *) 0;
+    }
+
     /* first check various obj lists directly */
     if ((obj = o_on(id, gi.invent)) != 0)
         return obj;
@@ -2660,6 +2669,7 @@ gem_learned(int oindx)
      * either paid before leaving or got treated as robbery and it's
      * too late to adjust pricing.
      */
+    id_index_begin();
     for (shkp = next_shkp(fmon, TRUE); shkp;
          shkp = next_shkp(shkp->nmon, TRUE)) {
         ct = ESHK(shkp)->billct;
@@ -2674,6 +2684,7 @@ gem_learned(int oindx)
             ++bp;
         }
     }
+    id_index_end();
 }
 
 /* called when an item's value has been enhanced; if it happens to be
@@ -2804,6 +2815,7 @@ add_to_billobjs(struct obj *obj)
     obj->nobj = gb.billobjs;
     gb.billobjs = obj;
     obj->where = OBJ_ONBILL;
+    sanity_touch_obj(obj);
 
     /* if hero drinks a shop-owned potion, it will have been flagged
        in_use by dodrink/dopotion but isn't being used up yet because
@@ -3647,11 +3659,13 @@ doinvbill(
            whether to include 'x' in its prompt string */
         int cnt = !eshkp->debit ? 0 : 1;
 
+        id_index_begin();
         for (bp = eshkp->bill_p, end_bp = &eshkp->bill_p[eshkp->billct];
              bp < end_bp; bp++)
             if (bp->useup
                 || ((obj = bp_to_obj(bp)) != 0 && obj->quan < bp->bquan))
                 cnt++;
+        id_index_end();
         return cnt;
     }
 
@@ -3660,11 +3674,13 @@ doinvbill(
     putstr(datawin, 0, "");
 
     totused = 0L;
+    id_index_begin();
     for (bp = eshkp->bill_p, end_bp = &eshkp->bill_p[eshkp->billct];
          bp < end_bp; bp++) {
         obj = bp_to_obj(bp);
         if (!obj) {
             impossible("Bad shopkeeper administration.");
+            id_index_end();
             goto quit;
         }
         if (bp->useup || bp->bquan > obj->quan) {
@@ -3681,6 +3697,7 @@ doinvbill(
             putstr(datawin, 0, buf_p);
         }
     }
+    id_index_end();
     if (eshkp->debit) {
         /* additional shop debt which has no itemization available */
         if (totused)
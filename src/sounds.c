@@ -1541,6 +1541,7 @@ typedef struct audio_mapping_rec {
 } audio_mapping;
 
 static audio_mapping *soundmap = 0;
+static struct regex_cache sound_cache; /* recent messages' mappings */
 static audio_mapping *sound_matches_message(const char *);
 
 char *sounddir = 0; /* set in files.c */
@@ -1620,13 +1621,16 @@ staticfn audio_mapping *
 sound_matches_message(const char *msg)
 {
     audio_mapping *snd = soundmap;
+    genericptr_t rule;
 
-    while (snd) {
-        if (regex_match(msg, snd->regex))
-            return snd;
+    if (!snd)
+        return snd;
+    if (regex_cache_find(&sound_cache, (genericptr_t) snd, msg, &rule))
+        return (audio_mapping *) rule;
+    while (snd && !regex_match(msg, snd->regex))
         snd = snd->next;
-    }
-    return (audio_mapping *) 0;
+    regex_cache_add(&sound_cache, msg, (genericptr_t) snd);
+    return snd;
 }
 
 void
@@ -1675,6 +1679,7 @@ release_sound_mappings(void)
         free((genericptr_t) soundmap);
         soundmap = nextsound;
     }
+    regex_cache_clear(&sound_cache);
 
     if (sounddir)
         free((genericptr_t) sounddir), sounddir = 0;
@@ -690,6 +690,10 @@ flip_level(
         if (flp & 2)
             etmp->engr_x = FlipX(etmp->engr_x);
     }
+    /* the location indices for all three */
+    reindex_stairs();
+    reindex_traps();
+    reindex_engravings();
 
     /* level (teleport) regions */
     for (i = 0; i < gn.num_lregions; i++) {
@@ -21,6 +21,8 @@ stairway_add(
     assign_level(&(tmp->tolev), dest);
     tmp->next = gs.stairs;
     gs.stairs = tmp;
+    if (isok(x, y))
+        gl.level.stairways[x][y] = tmp;
 }
 
 void
@@ -30,6 +32,9 @@ stairway_free_all(void)
 
     while (tmp) {
         stairway *tmp2 = tmp->next;
+
+        if (isok(tmp->sx, tmp->sy))
+            gl.level.stairways[tmp->sx][tmp->sy] = (stairway *) 0;
         free(tmp);
         tmp = tmp2;
     }
@@ -39,11 +44,24 @@ stairway_free_all(void)
 stairway *
 stairway_at(coordxy x, coordxy y)
 {
-    stairway *tmp = gs.stairs;
+    if (!isok(x, y))
+        return (stairway *) 0;
+    return gl.level.stairways[x][y];
+}
 
-    while (tmp && !(tmp->sx == x && tmp->sy == y))
-        tmp = tmp->next;
-    return tmp;
+/* rebuild the location index for this level's stairs and ladders */
+void
+reindex_stairs(void)
+{
+    stairway *tmp;
+    coordxy x, y;
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            gl.level.stairways[x][y] = (stairway *) 0;
+    for (tmp = gs.stairs; tmp; tmp = tmp->next)
+        if (isok(tmp->sx, tmp->sy) && !gl.level.stairways[tmp->sx][tmp->sy])
+            gl.level.stairways[tmp->sx][tmp->sy] = tmp;
 }
 
 stairway *
@@ -915,7 +915,9 @@ place_monster(struct monst *mon, coordxy x, coordxy y)
     }
     mon->mx = x, mon->my = y;
     gl.level.monsters[x][y] = mon;
+    freecell_update(x, y);
     mon->mstate = MON_FLOOR;
+    sanity_touch_mon(mon);
 }
 
 /*steed.c*/
@@ -7,6 +7,9 @@
 
 staticfn void savedsym_add(const char *, const char *, int);
 staticfn struct _savedsym *savedsym_find(const char *, int);
+staticfn unsigned symhash_key(const char *, size_t);
+staticfn void symhash_add(const char *, const struct symparse *);
+staticfn void symhash_init(void);
 
 extern const uchar def_r_oc_syms[MAXOCLASSES];      /* drawing.c */
 
@@ -848,10 +851,49 @@ parsesymbols(char *opts, int which_set)
     return TRUE;
 }
 
-const struct symparse *
-match_sym(char *buf)
+/* symbol keywords are looked up by hash instead of comparing each line
+   of the symbols file against every entry of loadsyms[] */
+#define SYMHASH_SIZE 1024 /* power of 2, comfortably over twice loadsyms[] */
+static struct symhash_slot {
+    const char *nm; /* keyword; Null for an empty slot */
+    const struct symparse *sp;
+} symhash[SYMHASH_SIZE];
+static boolean symhash_ready = FALSE;
+
+staticfn unsigned
+symhash_key(const char *nm, size_t len)
+{
+    unsigned hash = 2166136261U;
+
+    while (len--) {
+        hash ^= (unsigned) (uchar) lowc(*nm++);
+        hash *= 16777619U;
+    }
+    return hash ^ (hash >> 15);
+}
+
+/* add 'sp' under 'nm' unless an earlier entry already has that name */
+staticfn void
+symhash_add(const char *nm, const struct symparse *sp)
+{
+    unsigned h = symhash_key(nm, strlen(nm));
+
+    for (;; ++h) {
+        h &= (SYMHASH_SIZE - 1);
+        if (!symhash[h].nm) {
+            symhash[h].nm = nm;
+            symhash[h].sp = sp;
+            return;
+        }
+        if (!strcmpi(symhash[h].nm, nm))
+            return;
+    }
+}
+
+staticfn void
+symhash_init(void)
 {
-    static struct alternate_parse {
+    static const struct alternate_parse {
         const char *altnm;
         const char *nm;
     } alternates[] = {
@@ -863,10 +905,29 @@ match_sym(char *buf)
         { "S_explode6", "S_expl_mr" }, { "S_explode7", "S_expl_bl" },
         { "S_explode8", "S_expl_bc" }, { "S_explode9", "S_expl_br" },
     };
-    int i;
+    int i, j;
+
+    for (i = 0; loadsyms[i].range; ++i)
+        symhash_add(loadsyms[i].name, &loadsyms[i]);
+    /* alternates come after all the real names, as they did when this
+       was a linear search */
+    for (i = 0; i < SIZE(alternates); ++i) {
+        for (j = 0; loadsyms[j].range; ++j)
+            if (!strcmp(alternates[i].nm, loadsyms[j].name)) {
+                symhash_add(alternates[i].altnm, &loadsyms[j]);
+                break;
+            }
+    }
+    symhash_ready = TRUE;
+}
+
+const struct symparse *
+match_sym(char *buf)
+{
     size_t len = strlen(buf);
     const char *p = strchr(buf, ':'), *q = strchr(buf, '=');
-    const struct symparse *sp = loadsyms;
+    const char *nm;
+    unsigned h;
 
     /* G_ lines will never match here */
     if ((buf[0] == 'G' || buf[0] == 'g') && buf[1] == '_')
@@ -881,21 +942,14 @@ match_sym(char *buf)
             p--;
         len = (int) (p - buf);
     }
-    while (sp->range) {
-        if ((len >= strlen(sp->name)) && !strncmpi(buf, sp->name, len))
-            return sp;
-        sp++;
-    }
-    for (i = 0; i < SIZE(alternates); ++i) {
-        if ((len >= strlen(alternates[i].altnm))
-            && !strncmpi(buf, alternates[i].altnm, len)) {
-            sp = loadsyms;
-            while (sp->range) {
-                if (!strcmp(alternates[i].nm, sp->name))
-                    return sp;
-                sp++;
-            }
-        }
+    if (!symhash_ready)
+        symhash_init();
+    for (h = symhash_key(buf, len); ; ++h) {
+        h &= (SYMHASH_SIZE - 1);
+        if (!(nm = symhash[h].nm))
+            break;
+        if (strlen(nm) == len && !strncmpi(buf, nm, (int) len))
+            return symhash[h].sp;
     }
     return (struct symparse *) 0;
 }
@@ -15,6 +15,11 @@ staticfn void rloc_to_core(struct monst *, coordxy, coordxy, unsigned);
 staticfn void mvault_tele(struct monst *);
 staticfn boolean m_blocks_teleporting(struct monst *);
 staticfn stairway *stairway_find_forwiz(boolean, boolean);
+staticfn schar freecell_terrain(coordxy, coordxy);
+staticfn void freecell_swap(int, int);
+staticfn void freecell_move(coordxy, coordxy, int);
+staticfn void freecell_rebuild(void);
+staticfn boolean freecell_filter(coordxy, coordxy);
 
 /* does monster block others from teleporting? */
 staticfn boolean
@@ -176,6 +181,213 @@ goodpos(
     return TRUE;
 }
 
+/*
+ * Free cell index.
+ *
+ * gf.freecells keeps every map location in one of four groups: no
+ * monster and walkable terrain, no monster and water or lava, no monster
+ * and solid terrain, or occupied.  The groups are contiguous runs of
+ * cell[], in that order, so the candidates for any movement class are
+ * a prefix of it (walkers: FC_WALK; swimmers and flyers: through
+ * FC_WATER; wall-phasers: through FC_SOLID) and a random one can be
+ * picked in constant time.  Moving a location to another group costs at
+ * most three swaps.
+ *
+ * Monster arrival and departure keep it current (place_monster(),
+ * remove_monster(), place_worm_seg()), as does set_levltyp().  Terrain
+ * is changed directly in too many places to hook them all, so the index
+ * is also rebuilt from scratch on a new turn or level, for each random
+ * placement during level creation, and before an exhaustive search
+ * (a rebuild is cheap next to a single goodpos() sweep of the map);
+ * a random pick that
+ * turns out to be stale is refiled and another one made.  goodpos() has
+ * the final say on every location, so the index never has to be exact,
+ * it only must not leave out anything goodpos() might accept.
+ */
+
+/* classify the terrain at <x,y> for the free cell index */
+staticfn schar
+freecell_terrain(coordxy x, coordxy y)
+{
+    if (!isok(x, y))
+        return FC_TAKEN; /* column 0 never qualifies */
+    if (is_pool_or_lava(x, y))
+        return FC_WATER;
+    return ACCESSIBLE(SURFACE_AT(x, y)) ? FC_WALK : FC_SOLID;
+}
+
+staticfn void
+freecell_swap(int i, int j)
+{
+    struct freecells *fc = &gf.freecells;
+    short ci = fc->cell[i], cj = fc->cell[j];
+
+    fc->cell[i] = cj, fc->where[cj / ROWNO][cj % ROWNO] = i;
+    fc->cell[j] = ci, fc->where[ci / ROWNO][ci % ROWNO] = j;
+}
+
+/* put <x,y> into group 'to' */
+staticfn void
+freecell_move(coordxy x, coordxy y, int to)
+{
+    struct freecells *fc = &gf.freecells;
+    int k, pos = fc->where[x][y], from = 0;
+
+    while (pos >= fc->start[from + 1])
+        ++from;
+    /* cross one group boundary at a time by trading places with the
+       cell on the far side of it and then moving the boundary */
+    for (k = from; k < to; ++k) {
+        freecell_swap(pos, fc->start[k + 1] - 1);
+        pos = --fc->start[k + 1];
+    }
+    for (k = from; k > to; --k) {
+        freecell_swap(pos, fc->start[k]);
+        pos = fc->start[k]++;
+    }
+}
+
+staticfn void
+freecell_rebuild(void)
+{
+    struct freecells *fc = &gf.freecells;
+    int count[NUM_FC_KINDS], kind, i;
+    coordxy x, y;
+
+    for (kind = 0; kind < NUM_FC_KINDS; ++kind)
+        count[kind] = 0;
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            fc->terrain[x][y] = freecell_terrain(x, y);
+            ++count[MON_AT(x, y) ? FC_TAKEN : fc->terrain[x][y]];
+        }
+    fc->start[0] = 0;
+    for (kind = 0; kind < NUM_FC_KINDS; ++kind)
+        fc->start[kind + 1] = fc->start[kind] + count[kind];
+    /* count[] becomes the next free slot of each group */
+    for (kind = 0; kind < NUM_FC_KINDS; ++kind)
+        count[kind] = fc->start[kind];
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            kind = MON_AT(x, y) ? FC_TAKEN : fc->terrain[x][y];
+            i = count[kind]++;
+            fc->cell[i] = (short) (x * ROWNO + y);
+            fc->where[x][y] = (short) i;
+        }
+    fc->stamp = gm.moves;
+    fc->ledger = ledger_no(&u.uz);
+    fc->valid = TRUE;
+}
+
+/* note that a monster has arrived at or left <x,y> */
+void
+freecell_update(coordxy x, coordxy y)
+{
+    struct freecells *fc = &gf.freecells;
+
+    if (!fc->valid || !isok(x, y) || fc->ledger != ledger_no(&u.uz))
+        return;
+    freecell_move(x, y, MON_AT(x, y) ? FC_TAKEN : fc->terrain[x][y]);
+}
+
+/* note that the terrain at <x,y> has changed */
+void
+freecell_newterrain(coordxy x, coordxy y)
+{
+    struct freecells *fc = &gf.freecells;
+
+    if (!fc->valid || !isok(x, y) || fc->ledger != ledger_no(&u.uz))
+        return;
+    fc->terrain[x][y] = freecell_terrain(x, y);
+    freecell_update(x, y);
+}
+
+/* forget the index; the next use will rebuild it */
+void
+freecell_reset(void)
+{
+    gf.freecells.valid = FALSE;
+}
+
+/* the last group of free cells which might hold a spot acceptable to
+   goodpos(x, y, mtmp, gpflags); the candidates are FC_WALK through it */
+int
+freecell_kinds(struct monst *mtmp, mmflags_nht gpflags)
+{
+    if (!mtmp)
+        return (gpflags & (MM_IGNOREWATER | MM_IGNORELAVA)) ? FC_WATER
+                                                           : FC_WALK;
+    /* water and lava depend on more than mtmp->data (levitation, etc) */
+    if (mtmp == &gy.youmonst ? Passes_walls : passes_walls(mtmp->data))
+        return FC_SOLID;
+    return FC_WATER;
+}
+
+/* pick a random candidate location from groups FC_WALK through lastkind;
+   returns FALSE if there aren't any */
+boolean
+freecell_random(int lastkind, coord *cc)
+{
+    struct freecells *fc = &gf.freecells;
+    int n, pos;
+    coordxy x, y;
+    schar terrain;
+
+    if (!fc->valid || fc->stamp != gm.moves
+        || fc->ledger != ledger_no(&u.uz))
+        freecell_rebuild();
+    while ((n = fc->start[lastkind + 1]) > 0) {
+        pos = rn2(n);
+        x = fc->cell[pos] / ROWNO, y = fc->cell[pos] % ROWNO;
+        /* refile a location whose terrain or occupant changed behind
+           our back and try again */
+        terrain = freecell_terrain(x, y);
+        if (terrain != fc->terrain[x][y] || MON_AT(x, y)) {
+            fc->terrain[x][y] = terrain;
+            freecell_move(x, y, MON_AT(x, y) ? FC_TAKEN : terrain);
+            continue;
+        }
+        cc->x = x, cc->y = y;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* number of candidate locations in groups FC_WALK through lastkind; if
+   'exact' is set, rebuild the index first so that it can be relied on
+   to include every location goodpos() might accept */
+int
+freecell_count(int lastkind, boolean exact)
+{
+    struct freecells *fc = &gf.freecells;
+
+    if (exact || !fc->valid || fc->stamp != gm.moves
+        || fc->ledger != ledger_no(&u.uz))
+        freecell_rebuild();
+    fc->filterkind = lastkind;
+    return fc->start[lastkind + 1];
+}
+
+/* the candidate at position 'pos' of the index, for an exhaustive search
+   after freecell_count() */
+void
+freecell_nth(int pos, coord *cc)
+{
+    short c = gf.freecells.cell[pos];
+
+    cc->x = c / ROWNO, cc->y = c % ROWNO;
+}
+
+/* collect_coords() filter: only the candidates from the last
+   freecell_count() */
+staticfn boolean
+freecell_filter(coordxy x, coordxy y)
+{
+    struct freecells *fc = &gf.freecells;
+
+    return fc->where[x][y] < fc->start[fc->filterkind + 1];
+}
+
 /*
  * "entity next to"
  *
@@ -233,13 +445,19 @@ enexto_core(
 
     /* didn't find a spot; gather coordinates for the whole map except
        for <xx,yy> itself, ordered in expanding distance from <xx,yy>
-       (subsets of equal distance grouped together with order randomized) */
-    allcandyct = collect_coords(candy, xx, yy, 0, CC_NO_FLAGS,
-                                (boolean (*)(coordxy, coordxy)) 0);
-    /* skip first 'nearcandyct' spots, they have already been rejected;
-       they will occur in different random order but same overall total */
-    for (i = nearcandyct; i < allcandyct; ++i) {
+       (subsets of equal distance grouped together with order randomized);
+       only unoccupied spots with terrain that might suit 'mdat' are
+       worth handing to goodpos(), and if there aren't any, we're done */
+    allcandyct = 0;
+    if (freecell_count(freecell_kinds(&fakemon, entflags), TRUE) > 0)
+        allcandyct = collect_coords(candy, xx, yy, 0, CC_NO_FLAGS,
+                                    freecell_filter);
+    /* skip spots within 3 steps, they have already been rejected (the
+       filter means that they can't be skipped by count) */
+    for (i = 0; i < allcandyct; ++i) {
         *cc = candy[i];
+        if (distmin(xx, yy, cc->x, cc->y) <= 3)
+            continue;
         if (goodpos(cc->x, cc->y, &fakemon, entflags))
             return TRUE;
     }
@@ -699,7 +917,7 @@ safe_teleds(int teleds_flags)
 {
     coordxy nux, nuy;
     unsigned cc_flags;
-    coord candy[ROWNO * (COLNO - 1)], backupspot;
+    coord candy[ROWNO * (COLNO - 1)], backupspot, cc;
     int tcnt, candycount;
 
     /*
@@ -712,11 +930,14 @@ safe_teleds(int teleds_flags)
      * Now it tries completely randomly only 40 times, all disallowing
      * traps, then resorts to checking the entire map, near hero's spot
      * first then expanding out from there.  If no non-trap spot is found,
-     * first trap spot is used.
+     * first trap spot is used.  The random tries are drawn from the free
+     * cell index so that they aren't wasted on stone or occupied spots.
      */
     for (tcnt = 0; tcnt < 40; ++tcnt) {
-        nux = rnd(COLNO - 1);
-        nuy = rn2(ROWNO);
+        if (!freecell_random(freecell_kinds(&gy.youmonst, NO_MM_FLAGS),
+                             &cc))
+            break;
+        nux = cc.x, nuy = cc.y;
         if (teleok(nux, nuy, FALSE)) {
             teleds(nux, nuy, teleds_flags);
             return TRUE;
@@ -2155,6 +2155,7 @@ run_timers(void)
      * any time.  The list is ordered, we are done when the first element
      * is in the future.
      */
+    PROF_START(PROF_TIMERS);
     while (gt.timer_base && gt.timer_base->timeout <= gm.moves) {
         curr = gt.timer_base;
         gt.timer_base = curr->next;
@@ -2164,6 +2165,7 @@ run_timers(void)
         (*timeout_funcs[curr->func_index].f)(&curr->arg, curr->timeout);
         free((genericptr_t) curr);
     }
+    PROF_STOP(PROF_TIMERS);
 }
 
 /*
@@ -2682,6 +2684,7 @@ relink_timers(boolean ghostly)
     timer_element *curr;
     unsigned nid;
 
+    id_index_begin();
     for (curr = gt.timer_base; curr; curr = curr->next) {
         if (curr->needs_fixup) {
             if (curr->kind == TIMER_OBJECT) {
@@ -2700,6 +2703,7 @@ relink_timers(boolean ghostly)
                 panic("relink_timers 2");
         }
     }
+    id_index_end();
 }
 
 /*timeout.c*/
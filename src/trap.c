@@ -545,6 +545,7 @@ maketrap(coordxy x, coordxy y, int typ)
     if (!oldplace) {
         ttmp->ntrap = gf.ftrap;
         gf.ftrap = ttmp;
+        gl.level.traps[x][y] = ttmp;
     } else {
         /* oldplace;
            it shouldn't be possible to override a sokoban pit or hole
@@ -4446,6 +4447,7 @@ acid_damage(struct obj *obj)
         obj->otyp = SCR_BLANK_PAPER;
         obj->spe = 0;
         obj->dknown = 0;
+        obj_retyped(obj);
     } else
         erode_obj(obj, (char *) 0, ERODE_CORRODE, EF_GREASE | EF_VERBOSE);
 }
@@ -4584,6 +4586,7 @@ water_damage(
         obj->otyp = SCR_BLANK_PAPER;
         obj->dknown = 0;
         obj->spe = 0;
+        obj_retyped(obj);
         if (in_invent)
             update_inventory();
         return ER_DAMAGED;
@@ -4615,6 +4618,7 @@ water_damage(
         /* blanking a novel is more involved than blanking a spellbook */
         if (otyp == SPE_NOVEL) /* old type */
             blank_novel(obj);
+        obj_retyped(obj);
         if (in_invent)
             update_inventory();
         return ER_DAMAGED;
@@ -4630,6 +4634,7 @@ water_damage(
             obj->dknown = 0;
             obj->blessed = obj->cursed = 0;
             obj->odiluted = 0;
+            obj_retyped(obj);
             if (in_invent)
                 update_inventory();
             return ER_DAMAGED;
@@ -6222,14 +6227,26 @@ chest_trap(
 struct trap *
 t_at(coordxy x, coordxy y)
 {
-    struct trap *trap = gf.ftrap;
+    if (!isok(x, y))
+        return (struct trap *) 0;
+    return gl.level.traps[x][y];
+}
 
-    while (trap) {
-        if (trap->tx == x && trap->ty == y)
-            return trap;
-        trap = trap->ntrap;
-    }
-    return (struct trap *) 0;
+/* rebuild the location index for the traps on this level, for after
+   they've been moved around en masse */
+void
+reindex_traps(void)
+{
+    struct trap *trap;
+    coordxy x, y;
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            gl.level.traps[x][y] = (struct trap *) 0;
+    /* if two traps somehow share a spot, the first one is found */
+    for (trap = gf.ftrap; trap; trap = trap->ntrap)
+        if (isok(trap->tx, trap->ty) && !gl.level.traps[trap->tx][trap->ty])
+            gl.level.traps[trap->tx][trap->ty] = trap;
 }
 
 /* return number of traps of type ttyp on this level */
@@ -6264,6 +6281,15 @@ deltrap(struct trap *trap)
             panic("deltrap: no preceding trap!");
         ttmp->ntrap = trap->ntrap;
     }
+    if (isok(trap->tx, trap->ty)
+        && gl.level.traps[trap->tx][trap->ty] == trap) {
+        gl.level.traps[trap->tx][trap->ty] = (struct trap *) 0;
+        for (ttmp = gf.ftrap; ttmp; ttmp = ttmp->ntrap)
+            if (ttmp->tx == trap->tx && ttmp->ty == trap->ty) {
+                gl.level.traps[trap->tx][trap->ty] = ttmp;
+                break;
+            }
+    }
     if (Sokoban && (trap->ttyp == PIT || trap->ttyp == HOLE))
         maybe_finish_sokoban();
     dealloc_trap(trap);
@@ -6907,14 +6933,26 @@ void
 trap_sanity_check(void)
 {
     struct trap *ttmp = gf.ftrap;
+    int ntraps = 0, nindexed = 0;
+    coordxy x, y;
 
     while (ttmp) {
+        ++ntraps;
         if (!isok(ttmp->tx, ttmp->ty))
             impossible("trap sanity: location (%i,%i)", ttmp->tx, ttmp->ty);
+        else if (gl.level.traps[ttmp->tx][ttmp->ty] != ttmp)
+            impossible("trap sanity: not indexed at (%i,%i)",
+                       ttmp->tx, ttmp->ty);
         if (ttmp->ttyp <= NO_TRAP || ttmp->ttyp >= TRAPNUM)
             impossible("trap sanity: type (%i)", ttmp->ttyp);
         ttmp = ttmp->ntrap;
     }
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            if (gl.level.traps[x][y])
+                ++nindexed;
+    if (nindexed != ntraps)
+        impossible("trap sanity: %d traps, %d indexed", ntraps, nindexed);
 }
 
 /*trap.c*/
@@ -1210,6 +1210,7 @@ hmon_hitmon_misc_obj(
                 obj->spe = 0;
                 obj->known = obj->dknown = obj->bknown = 0;
                 obj->owt = weight(obj);
+                obj_retyped(obj);
                 if (hmd->thrown)
                     place_object(obj, mon->mx, mon->my);
             } else {
@@ -497,7 +497,6 @@ new_angle(struct rm *lev, unsigned char *sv, int row, int col)
  *      + Right after a scroll of light is read. [litroom()]
  *      + After an option has changed that affects vision [parseoptions()]
  *      + Right after the hero is swallowed. [gulpmu()]
- *      + Just before bubbles are moved. [movebubbles()]
  */
 void
 vision_recalc(int control)
@@ -523,6 +522,7 @@ vision_recalc(int control)
     gv.vision_full_recalc = 0; /* reset flag */
     if (gi.in_mklev || !iflags.vision_inited)
         return;
+    PROF_START(PROF_VISION);
 
     /*
      * Either the light sources have been taken care of, or we must
@@ -835,6 +835,7 @@ vision_recalc(int control)
     gv.viz_rmax = next_rmax;
 
     notice_all_mons(TRUE);
+    PROF_STOP(PROF_VISION);
 }
 
 /*
@@ -473,6 +473,8 @@ oselect(struct monst *mtmp, int type)
 {
     struct obj *otmp;
 
+    if (!m_might_carry(mtmp, type))
+        return (struct obj *) 0;
     for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj) {
         if (otmp->otyp != type)
             continue;
@@ -566,6 +568,7 @@ select_rwep(struct monst *mtmp)
         /* shooting gems from slings; this goes just before the darts */
         /* (shooting rocks is already handled via the rwep[] ordering) */
         if (rwep[i] == DART && !likes_gems(mtmp->data)
+            && m_might_carry_class(mtmp, GEM_CLASS)
             && m_carrying(mtmp, SLING)) { /* propellor */
             for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj)
                 if (otmp->oclass == GEM_CLASS
@@ -661,7 +664,8 @@ select_hwep(struct monst *mtmp)
     boolean wearing_shield = (mtmp->misc_worn_check & W_ARMS) != 0;
 
     /* prefer artifacts to everything else */
-    for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj) {
+    for (otmp = m_might_carry_class(mtmp, WEAPON_CLASS) ? mtmp->minvent : 0;
+         otmp; otmp = otmp->nobj) {
         if (otmp->oclass == WEAPON_CLASS && otmp->oartifact
             && touch_artifact(otmp, mtmp)
             && ((strong && !wearing_shield)
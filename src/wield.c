@@ -949,6 +949,7 @@ chwepon(struct obj *otmp, int amount)
         Your("%s %s much sharper now.", simpleonames(uwep),
              multiple ? "fuse, and become" : "is");
         uwep->otyp = CRYSKNIFE;
+        obj_retyped(uwep);
         uwep->oerodeproof = 0;
         if (multiple) {
             uwep->quan = 1L;
@@ -971,6 +972,7 @@ chwepon(struct obj *otmp, int amount)
              multiple ? "fuse, and become" : "is");
         costly_alteration(uwep, COST_DEGRD); /* DECHNT? other? */
         uwep->otyp = WORM_TOOTH;
+        obj_retyped(uwep);
         uwep->oerodeproof = 0;
         if (multiple) {
             uwep->quan = 1L;
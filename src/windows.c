@@ -66,6 +66,7 @@ staticfn struct win_choices *win_choices_find(const char *s) NONNULLARG1;
 staticfn void def_raw_print(const char *s) NONNULLARG1;
 staticfn void def_wait_synch(void);
 staticfn boolean get_menu_coloring(const char *, int *, int *) NONNULLPTRS;
+staticfn unsigned long anim_clock(void);
 
 staticfn winid dump_create_nhwindow(int);
 staticfn void dump_clear_nhwindow(winid);
@@ -1761,7 +1762,7 @@ choose_classes_menu(const char *prompt,
 /* enum and structs are defined in wintype.h */
 
 win_request_info zerowri = { { 0L, 0, 0, 0, 0, 0, 0, 0 },
-                             { 0, 0, { NO_COLOR, ATR_NONE }}};
+                             { 0, 0, { NO_COLOR, ATR_NONE }, 0L, 0UL, 0 } };
 
 void
 adjust_menu_promptstyle(winid window, color_attr *style)
@@ -1834,13 +1835,11 @@ get_menu_coloring(const char *str, int *color, int *attr)
 {
     struct menucoloring *tmpmc;
 
-    if (iflags.use_menu_color)
-        for (tmpmc = gm.menu_colorings; tmpmc; tmpmc = tmpmc->next)
-            if (regex_match(str, tmpmc->match)) {
-                *color = tmpmc->color;
-                *attr = tmpmc->attr;
-                return TRUE;
-            }
+    if (iflags.use_menu_color && (tmpmc = menu_coloring_match(str)) != 0) {
+        *color = tmpmc->color;
+        *attr = tmpmc->attr;
+        return TRUE;
+    }
     return FALSE;
 }
 
@@ -1866,4 +1865,59 @@ getlin(const char *query, char *bufp)
     gb.bot_disabled = old_bot_disabled;
     gp.program_state.in_getlin = 0;
 }
+
+/* milliseconds since an arbitrary starting point */
+staticfn unsigned long
+anim_clock(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long) ts.tv_sec * 1000UL
+           + (unsigned long) ts.tv_nsec / 1000000UL;
+#else
+    return (unsigned long) ((double) clock() * 1000.0
+                            / (double) CLOCKS_PER_SEC);
+#endif
+}
+
+/*
+ *   Common code point leading into the interface-specific
+ *   delay_output().  An interface which sets WC2_ANIMFRAMES is
+ *   told where each animation frame ends, and when it ought to be
+ *   shown, via ctrl_nhwindow(WIN_MAP, anim_frame, ...) and the game
+ *   carries on without waiting; the interface paces the playback.
+ *   If it declines the request, fall back to delay_output().
+ */
+void
+nh_delay_output(void)
+{
+    win_request_info wri;
+    unsigned long now;
+
+    if ((windowprocs.wincap2 & WC2_ANIMFRAMES) != 0 && WIN_MAP != WIN_ERR) {
+        if (iflags.debug_fuzzer)
+            return;
+        wri = zerowri;
+        wri.fromcore.frame_delay = 50;
+#ifdef TIMED_DELAY
+        if (!flags.nap)
+            wri.fromcore.frame_delay = 0;
+#endif
+        /* frames are due frame_delay apart; the first one of a burst,
+           or one coming after the interface has caught up, is due now */
+        now = anim_clock();
+        if (ga.anim_due + (unsigned long) wri.fromcore.frame_delay > now)
+            now = ga.anim_due + (unsigned long) wri.fromcore.frame_delay;
+        wri.fromcore.frame_ms = now;
+        wri.fromcore.frame_num = ga.anim_frameno + 1L;
+        if (ctrl_nhwindow(WIN_MAP, anim_frame, &wri)) {
+            ga.anim_due = now;
+            ++ga.anim_frameno;
+            return;
+        }
+    }
+    (*windowprocs.win_delay_output)();
+}
 /*windows.c*/
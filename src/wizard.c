@@ -107,6 +107,8 @@ mon_has_amulet(struct monst *mtmp)
 {
     struct obj *otmp;
 
+    if (!m_might_carry(mtmp, AMULET_OF_YENDOR))
+        return 0;
     for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj)
         if (otmp->otyp == AMULET_OF_YENDOR)
             return 1;
@@ -4,6 +4,12 @@
 
 #include "hack.h"
 #include "func_tab.h"
+#ifdef FUZZ_SNAPSHOTS
+#include <fcntl.h>
+#ifdef PANICTRACE_LIBC
+#include <execinfo.h>
+#endif
+#endif
 
 extern const char unavailcmd[];                  /* cmd.c [27] */
 extern const char *levltyp[MAX_TYPE + 2];          /* cmd.c */
@@ -18,11 +24,31 @@ staticfn void mon_invent_chain(winid, const char *, struct monst *, long *,
 staticfn void mon_chain(winid, const char *, struct monst *, boolean, long *,
                       long *);
 staticfn void contained_stats(winid, const char *, long *, long *);
+staticfn void pool_stats(winid);
 staticfn void misc_stats(winid, long *, long *);
 staticfn void you_sanity_check(void);
+staticfn boolean sanity_full_pass_due(void);
+staticfn void sanity_queue_reset(void);
+staticfn void incremental_sanity_check(void);
 staticfn void makemap_unmakemon(struct monst *, boolean);
 staticfn int QSORTCALLBACK migrsort_cmp(const genericptr, const genericptr);
 staticfn void list_migrating_mons(d_level *);
+#ifdef FUZZ_SNAPSHOTS
+staticfn boolean fuzz_init(void);
+staticfn boolean fuzz_in_shop(void);
+staticfn boolean fuzz_in_mines(void);
+staticfn boolean fuzz_in_sokoban(void);
+staticfn boolean fuzz_in_quest(void);
+staticfn boolean fuzz_in_gehennom(void);
+staticfn boolean fuzz_in_endgame(void);
+staticfn void fuzz_snapshot(const char *) NONNULLARG1;
+staticfn void fuzz_worker(const char *) NONNULLARG1;
+staticfn void fuzz_signal(int);
+staticfn void fuzz_cat(char *, size_t, const char *) NONNULLPTRS;
+staticfn void fuzz_catnum(char *, size_t, uint64, unsigned, int) NONNULLARG1;
+staticfn void fuzz_unlink_levels(void);
+staticfn long fuzz_msecs(void);
+#endif
 
 DISABLE_WARNING_FORMAT_NONLITERAL
 
@@ -562,6 +588,24 @@ wiz_polyself(void)
     return ECMD_OK;
 }
 
+/* #wizprofile command - show where the time per turn is being spent */
+int
+wiz_profile(void)
+{
+#ifdef HOTPATH_PROFILING
+    winid win = create_nhwindow(NHW_TEXT);
+
+    prof_show(win);
+    display_nhwindow(win, TRUE);
+    destroy_nhwindow(win);
+    if (y_n("Reset the profile counters?") == 'y')
+        prof_reset();
+#else
+    pline("Hot-path profiling is not available in this build.");
+#endif
+    return ECMD_OK;
+}
+
 /* #seenv command */
 int
 wiz_show_seenv(void)
@@ -1264,6 +1308,26 @@ mon_chain(
     }
 }
 
+/* slab allocation pools for objects, monsters, and their extensions */
+staticfn void
+pool_stats(winid win)
+{
+    static const char pool_fmt[] = "  %-12s %5ld %7ld %7ld %7ld %5ld %8ld",
+                      pool_hdr[] =
+                      "  Pools        slabs  in use    free    peak  rlsd"
+                      "    bytes";
+    char buf[BUFSZ];
+    struct nhpool *pool;
+
+    putstr(win, 0, pool_hdr);
+    for (pool = nhpool_list(); pool; pool = pool->nextpool) {
+        Snprintf(buf, sizeof buf, pool_fmt, pool->name, pool->nslabs,
+                 pool->inuse, pool->nfree, pool->peak, pool->released,
+                 nhpool_bytes(pool));
+        putstr(win, 0, buf);
+    }
+}
+
 staticfn void
 misc_stats(
     winid win,
@@ -1417,6 +1481,10 @@ sanity_check(void)
         iflags.sanity_no_check = FALSE;
         return;
     }
+    if (iflags.sanity_budget > 0 && !sanity_full_pass_due()) {
+        incremental_sanity_check();
+        return;
+    }
     you_sanity_check();
     obj_sanity_check();
     timer_sanity_check();
@@ -1425,6 +1493,172 @@ sanity_check(void)
     bc_sanity_check();
     trap_sanity_check();
     engraving_sanity_check();
+    sanity_queue_reset();
+}
+
+/*
+ * Incremental sanity checking, for when sanity_check_budget is non-zero.
+ *
+ * Rather than walking every structure every turn, objects and monsters
+ * which have been placed, moved, or pulled off a list since they were
+ * last checked are queued by sanity_touch_obj() and sanity_touch_mon().
+ * Each turn, up to sanity_check_budget of those are re-validated; any
+ * budget left over is spent on a rotating slice of map locations.  One
+ * of the cheaper whole-list checks (timers, light sources, and so on)
+ * is also run each turn, in rotation.  Everything gets a full check
+ * every sanity_check_interval turns, when arriving on a new level, or
+ * whenever the touched queue overflows.
+ */
+
+#define SANITY_QUEUE_SIZE 512
+
+static struct sanity_queue {
+    struct obj *objs[SANITY_QUEUE_SIZE];
+    struct monst *mons[SANITY_QUEUE_SIZE];
+    int objcnt, moncnt;
+    boolean active;   /* queue is being maintained */
+    boolean overflow; /* something touched was dropped; need full pass */
+    int mapcursor;    /* next map spot for the rotating slice */
+    int listcursor;   /* next whole-list check for the rotation */
+    long last_full;   /* gm.moves of most recent full check */
+    d_level lev;      /* level the queue applies to */
+} sanq;
+
+static void (*const sanity_rotation[])(void) = {
+    you_sanity_check,
+    timer_sanity_check,
+    light_sources_sanity_check,
+    bc_sanity_check,
+    trap_sanity_check,
+    engraving_sanity_check,
+    wormno_sanity_check,
+};
+
+/* is it time for a full, non-incremental sanity check? */
+staticfn boolean
+sanity_full_pass_due(void)
+{
+    return (!sanq.active || sanq.overflow
+            || !on_level(&sanq.lev, &u.uz)
+            || (iflags.sanity_interval > 0
+                && gm.moves - sanq.last_full >= iflags.sanity_interval));
+}
+
+/* forget any queued objects and monsters after a full check */
+staticfn void
+sanity_queue_reset(void)
+{
+    sanq.objcnt = sanq.moncnt = 0;
+    sanq.overflow = FALSE;
+    sanq.active = (iflags.sanity_budget > 0);
+    sanq.last_full = gm.moves;
+    assign_level(&sanq.lev, &u.uz);
+}
+
+staticfn void
+incremental_sanity_check(void)
+{
+    int budget = iflags.sanity_budget, n, i;
+    coordxy x, y;
+
+    /* recently touched objects and monsters first; anything which
+       doesn't fit within the budget waits until next turn */
+    n = min(sanq.moncnt, budget);
+    for (i = 0; i < n; ++i)
+        mon_sanity_check_one(sanq.mons[i]);
+    if (n) {
+        sanq.moncnt -= n;
+        (void) memmove((genericptr_t) &sanq.mons[0],
+                       (genericptr_t) &sanq.mons[n],
+                       sanq.moncnt * sizeof sanq.mons[0]);
+        budget -= n;
+    }
+    n = min(sanq.objcnt, budget);
+    for (i = 0; i < n; ++i)
+        obj_sanity_check_one(sanq.objs[i]);
+    if (n) {
+        sanq.objcnt -= n;
+        (void) memmove((genericptr_t) &sanq.objs[0],
+                       (genericptr_t) &sanq.objs[n],
+                       sanq.objcnt * sizeof sanq.objs[0]);
+        budget -= n;
+    }
+
+    /* then a slice of the map, picking up where the last one left off;
+       column 0 is included since it is supposed to be empty */
+    while (budget-- > 0) {
+        x = (coordxy) (sanq.mapcursor / ROWNO);
+        y = (coordxy) (sanq.mapcursor % ROWNO);
+        obj_sanity_check_at(x, y);
+        if (x > 0)
+            mon_sanity_check_at(x, y);
+        if (++sanq.mapcursor >= COLNO * ROWNO)
+            sanq.mapcursor = 0;
+    }
+
+    (*sanity_rotation[sanq.listcursor])();
+    if (++sanq.listcursor >= SIZE(sanity_rotation))
+        sanq.listcursor = 0;
+}
+
+/* note that 'obj' has been placed, moved, or removed from a list */
+void
+sanity_touch_obj(struct obj *obj)
+{
+    int i;
+
+    if (!sanq.active || sanq.overflow)
+        return;
+    for (i = sanq.objcnt - 1; i >= 0; --i)
+        if (sanq.objs[i] == obj)
+            return;
+    if (sanq.objcnt < SANITY_QUEUE_SIZE)
+        sanq.objs[sanq.objcnt++] = obj;
+    else
+        sanq.overflow = TRUE;
+}
+
+/* note that 'mon' has been placed, moved, or removed from the map */
+void
+sanity_touch_mon(struct monst *mon)
+{
+    int i;
+
+    if (!sanq.active || sanq.overflow)
+        return;
+    for (i = sanq.moncnt - 1; i >= 0; --i)
+        if (sanq.mons[i] == mon)
+            return;
+    if (sanq.moncnt < SANITY_QUEUE_SIZE)
+        sanq.mons[sanq.moncnt++] = mon;
+    else
+        sanq.overflow = TRUE;
+}
+
+/* 'obj' is about to be freed; take it out of the touched queue */
+void
+sanity_forget_obj(struct obj *obj)
+{
+    int i;
+
+    for (i = sanq.objcnt - 1; i >= 0; --i)
+        if (sanq.objs[i] == obj) {
+            sanq.objs[i] = sanq.objs[--sanq.objcnt];
+            break;
+        }
+}
+
+/* 'mon' is about to be freed; take it out of the touched queue */
+void
+sanity_forget_mon(struct monst *mon)
+{
+    int i;
+
+    for (i = sanq.moncnt - 1; i >= 0; --i)
+        if (sanq.mons[i] == mon) {
+            sanq.mons[i] = sanq.mons[--sanq.moncnt];
+            break;
+        }
 }
 
 /* qsort() comparison routine for use in list_migrating_mons() */
@@ -1634,6 +1868,10 @@ wiz_show_stats(void)
              + total_ovr_size + total_misc_size));
     putstr(win, 0, buf);
 
+    /* pooled memory is already accounted for by the totals above */
+    putstr(win, 0, "");
+    pool_stats(win);
+
 #if defined(__BORLANDC__) && !defined(_WIN32)
     show_borlandc_stats(win);
 #endif
@@ -1873,7 +2111,7 @@ wiz_custom(void)
 }
 
 void
-wizcustom_callback(winid win, int glyphnum, char *id)
+wizcustom_callback(winid win, int glyphnum, const char *id)
 {
     extern glyph_map glyphmap[MAX_GLYPH];
     glyph_map *cgm;
@@ -1915,4 +2153,452 @@ wizcustom_callback(winid win, int glyphnum, char *id)
     return;
 }
 
+#ifdef FUZZ_SNAPSHOTS
+/*
+ * Fork-snapshot fuzzing.
+ *
+ * When NH_FUZZDIR names a directory, a game being driven by the fuzz
+ * tester stops the first time it gets somewhere interesting (each new
+ * FUZZ_DEPTH_STEP levels of depth, and the places in fuzz_marks[]),
+ * and forks short-lived workers which carry on from there with their
+ * own random seeds for a few turns each, several at a time; then the
+ * game itself resumes fuzzing until the next such place.  Setting up
+ * the state is paid for once instead of once per run.
+ *
+ * NH_FUZZSNAP="workers,runs,turns" sets how many workers run at once,
+ * how many runs are made from each snapshot, and how many game turns
+ * each one lasts.  A worker doesn't draw anything.  When it panics
+ * (fuzzing turns impossible() into panic()), crashes, or is still
+ * running after FUZZ_WORKER_SECS, the stack is hashed and a report is
+ * written to NH_FUZZDIR/<kind>-<hash>.txt unless that file exists
+ * already, so each distinct failure is reported once.  A line giving
+ * the number of runs per second is added to NH_FUZZDIR/fuzzlog for
+ * each snapshot.  A report for a signal is written from the signal
+ * handler, which sticks to async-signal-safe calls: it hashes the raw
+ * return addresses (the same in every worker forked from one game, but
+ * not from one run of the program to the next) instead of the symbolic
+ * frames used for panics.
+ *
+ * Workers write the levels they leave under a lock name of their own,
+ * and read levels they haven't written yet from the files of the game
+ * they were forked from (see open_levelfile()); that game waits for
+ * all of them before it carries on.
+ */
+
+#define FUZZ_DEPTH_STEP 5
+#define FUZZ_WORKER_SECS 30
+#define FUZZ_EXIT_CRASH 3
+#define FUZZ_EXIT_HANG 4
+
+static struct fuzzsnap {
+    int state;            /* 0: not set up yet, 1: on, -1: off */
+    char dir[BUFSZ];      /* NH_FUZZDIR */
+    int workers;          /* runs in progress at once */
+    int runs;             /* runs made from each snapshot */
+    int turns;            /* game turns in each run */
+    int nextdepth;        /* next depth to snapshot at */
+    unsigned long marked; /* fuzz_marks[] already snapshotted */
+    /* the rest are only used in a worker */
+    const char *label;    /* snapshot it was forked from */
+    long startmoves, stopmoves;
+    char parentlock[LOCKNAMESIZE];
+} fuzzsnap;
+
+static const struct fuzz_mark {
+    const char *label;
+    boolean (*reached)(void);
+} fuzz_marks[] = {
+    { "shop", fuzz_in_shop },
+    { "mines", fuzz_in_mines },
+    { "sokoban", fuzz_in_sokoban },
+    { "quest", fuzz_in_quest },
+    { "gehennom", fuzz_in_gehennom },
+    { "endgame", fuzz_in_endgame },
+};
+
+staticfn boolean
+fuzz_in_shop(void)
+{
+    return (*u.ushops != '\0');
+}
+
+staticfn boolean
+fuzz_in_mines(void)
+{
+    return In_mines(&u.uz);
+}
+
+staticfn boolean
+fuzz_in_sokoban(void)
+{
+    return In_sokoban(&u.uz);
+}
+
+staticfn boolean
+fuzz_in_quest(void)
+{
+    return In_quest(&u.uz);
+}
+
+staticfn boolean
+fuzz_in_gehennom(void)
+{
+    return In_hell(&u.uz);
+}
+
+staticfn boolean
+fuzz_in_endgame(void)
+{
+    return In_endgame(&u.uz);
+}
+
+/* milliseconds from an arbitrary starting point */
+staticfn long
+fuzz_msecs(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long) ts.tv_sec * 1000L + (long) (ts.tv_nsec / 1000000L);
+}
+
+/* look at the environment the first time through */
+staticfn boolean
+fuzz_init(void)
+{
+    const char *dir, *parms;
+    int workers = 4, runs = 200, turns = 100;
+
+    if (fuzzsnap.state)
+        return (fuzzsnap.state > 0);
+    fuzzsnap.state = -1;
+    if (!(dir = nh_getenv("NH_FUZZDIR")) || !*dir)
+        return FALSE;
+    if ((parms = nh_getenv("NH_FUZZSNAP")) != 0)
+        (void) sscanf(parms, "%d,%d,%d", &workers, &runs, &turns);
+    fuzzsnap.workers = max(workers, 1);
+    fuzzsnap.runs = max(runs, 1);
+    fuzzsnap.turns = max(turns, 1);
+    Snprintf(fuzzsnap.dir, sizeof fuzzsnap.dir, "%s", dir);
+    fuzzsnap.nextdepth = FUZZ_DEPTH_STEP;
+    fuzzsnap.marked = 0UL;
+    fuzzsnap.state = 1;
+    return TRUE;
+}
+
+/* called at the start of each command while fuzzing */
+void
+fuzz_snapshot_check(void)
+{
+    char label[QBUFSZ];
+    int i, dpth;
+
+    if (gp.program_state.fuzz_worker) {
+        if (gm.moves >= fuzzsnap.stopmoves)
+            fuzz_worker_done(EXIT_SUCCESS);
+        return;
+    }
+    if (!fuzz_init())
+        return;
+    if ((dpth = depth(&u.uz)) >= fuzzsnap.nextdepth) {
+        fuzzsnap.nextdepth = (dpth / FUZZ_DEPTH_STEP + 1) * FUZZ_DEPTH_STEP;
+        Sprintf(label, "depth%d", dpth);
+        fuzz_snapshot(label);
+    }
+    for (i = 0; i < SIZE(fuzz_marks); ++i) {
+        /* a worker returns from fuzz_snapshot() to start its run */
+        if (gp.program_state.fuzz_worker)
+            break;
+        if (!(fuzzsnap.marked & (1UL << i)) && (*fuzz_marks[i].reached)()) {
+            fuzzsnap.marked |= 1UL << i;
+            fuzz_snapshot(fuzz_marks[i].label);
+        }
+    }
+}
+
+/* run all the continuations from the current state */
+staticfn void
+fuzz_snapshot(const char *label)
+{
+    char fname[BUFSZ];
+    FILE *fp;
+    long elapsed;
+    int pid, status, started = 0, running = 0, crashes = 0, hangs = 0;
+
+#ifdef PREGEN_LEVELS
+    pregen_cancel(); /* wait() below would accept it in place of a worker */
+#endif
+    (void) fflush(stdout);
+    /* workers mustn't inherit queued entries and append them again */
+    livelog_flush(TRUE);
+    elapsed = fuzz_msecs();
+    while (started < fuzzsnap.runs || running > 0) {
+        if (started < fuzzsnap.runs && running < fuzzsnap.workers) {
+            if ((pid = fork()) == 0) {
+                fuzz_worker(label);
+                return;
+            }
+            if (pid > 0) {
+                ++started, ++running;
+                continue;
+            }
+            /* out of processes; finish with the ones we have */
+            if (!running)
+                break;
+            started = fuzzsnap.runs;
+        }
+        if ((pid = wait(&status)) < 0)
+            break;
+        --running;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == FUZZ_EXIT_HANG)
+            ++hangs;
+        else if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+            ++crashes;
+    }
+    elapsed = fuzz_msecs() - elapsed;
+
+    Snprintf(fname, sizeof fname, "%s/fuzzlog", fuzzsnap.dir);
+    if ((fp = fopen(fname, "a")) != 0) {
+        (void) fprintf(fp,
+                "%s T:%ld: %d runs of %d turns, %d crashed, %d hung, "
+                       "%.1f runs/sec\n",
+                       label, gm.moves, started, fuzzsnap.turns, crashes,
+                       hangs,
+                       started * 1000.0 / (double) max(elapsed, 1L));
+        (void) fclose(fp);
+    }
+}
+
+/* set up a worker, which then goes on with the game */
+staticfn void
+fuzz_worker(const char *label)
+{
+    gp.program_state.fuzz_worker = 1;
+    nhwindows_hangup();
+    (void) signal(SIGINT, SIG_IGN);
+    (void) signal(SIGQUIT, SIG_IGN);
+    (void) signal(SIGHUP, SIG_IGN);
+    (void) signal(SIGSEGV, fuzz_signal);
+    (void) signal(SIGBUS, fuzz_signal);
+    (void) signal(SIGFPE, fuzz_signal);
+    (void) signal(SIGILL, fuzz_signal);
+    (void) signal(SIGABRT, fuzz_signal);
+    (void) signal(SIGALRM, fuzz_signal);
+    (void) alarm(FUZZ_WORKER_SECS);
+#ifdef PANICTRACE_LIBC
+    {
+        void *bt[1];
+
+        /* the first backtrace() loads libgcc, which mustn't happen for
+           the first time inside fuzz_signal() */
+        (void) backtrace(bt, 1);
+    }
+#endif
+#ifdef PREGEN_LEVELS
+    iflags.pregen_levels = FALSE;
+#endif
+    /* a different continuation each time */
+    init_random(rn2);
+    init_random(rn2_on_display_rng);
+    fuzzsnap.label = label;
+    fuzzsnap.startmoves = gm.moves;
+    fuzzsnap.stopmoves = gm.moves + fuzzsnap.turns;
+    /* keep the parent's level files intact */
+    Strcpy(fuzzsnap.parentlock, gl.lock);
+    Sprintf(gl.lock, "fuzz%d", (int) getpid());
+}
+
+/* name of the parent game's file for a level this worker hasn't
+   written; used by open_levelfile() */
+const char *
+fuzz_parent_levelfile(int lev)
+{
+    set_levelfile_name(fuzzsnap.parentlock, lev);
+    return fqname(fuzzsnap.parentlock, LEVELPREFIX, 1);
+}
+
+/* end a worker's run */
+void
+fuzz_worker_done(int status)
+{
+    clearlocks();
+    _exit(status);
+}
+
+/* strcat() bounded by 'bufsz', for fuzz_signal() */
+staticfn void
+fuzz_cat(char *buf, size_t bufsz, const char *str)
+{
+    size_t n = strlen(buf);
+
+    while (*str && n + 1 < bufsz)
+        buf[n++] = *str++;
+    buf[n] = '\0';
+}
+
+/* append 'val' in 'base', at least 'mindigits' long; fuzz_signal()
+   can't use sprintf() */
+staticfn void
+fuzz_catnum(char *buf, size_t bufsz, uint64 val, unsigned base,
+            int mindigits)
+{
+    char digits[24], out[2];
+    int i = 0;
+
+    do {
+        digits[i++] = "0123456789abcdef"[val % base];
+        val /= base;
+    } while ((val || i < mindigits) && i < (int) sizeof digits);
+    out[1] = '\0';
+    while (i > 0) {
+        out[0] = digits[--i];
+        fuzz_cat(buf, bufsz, out);
+    }
+}
+
+/* clearlocks() for fuzz_signal(): remove this worker's level files,
+   with nothing but unlink() */
+staticfn void
+fuzz_unlink_levels(void)
+{
+    char name[BUFSZ], *p;
+    int x;
+
+    for (x = (gn.n_dgns ? maxledgerno() : 0); x >= 0; x--) {
+        if (x && !(gl.level_info[x].flags & LFILE_EXISTS))
+            continue;
+        name[0] = '\0';
+#ifdef PREFIXES_IN_USE
+        if (gf.fqn_prefix[LEVELPREFIX])
+            fuzz_cat(name, sizeof name, gf.fqn_prefix[LEVELPREFIX]);
+#endif
+        p = eos(name);
+        fuzz_cat(name, sizeof name, gl.lock);
+        /* gl.lock might still have a level number from earlier */
+        if ((p = strrchr(p, '.')) != 0)
+            *p = '\0';
+        fuzz_cat(name, sizeof name, ".");
+        fuzz_catnum(name, sizeof name, (uint64) x, 10, 1);
+        (void) unlink(name);
+    }
+}
+
+/* a worker has crashed or hung; report it (once per distinct stack)
+   and exit without going near stdio, malloc, or anything else which
+   the failure might have left in a state we'd deadlock on */
+staticfn void
+fuzz_signal(int sig)
+{
+    static volatile sig_atomic_t exitcode = 0;
+    char fname[BUFSZ], info[BUFSZ];
+    const char *kind;
+    uint64 h;
+    int fd, dpth;
+#ifdef PANICTRACE_LIBC
+    void *bt[30];
+    int count;
+#endif
+
+    /* another signal while reporting; give up on the report */
+    if (exitcode)
+        _exit(exitcode);
+    exitcode = (sig == SIGALRM) ? FUZZ_EXIT_HANG : FUZZ_EXIT_CRASH;
+    kind = (sig == SIGALRM) ? "hang" : "signal";
+
+    h = hash_bytes(0, (genericptr_t) kind, strlen(kind));
+#ifdef PANICTRACE_LIBC
+    count = backtrace(bt, SIZE(bt));
+    h = hash_bytes(h, (genericptr_t) bt, (size_t) count * sizeof bt[0]);
+#else
+    h = hash_bytes(h, (genericptr_t) &sig, sizeof sig);
+#endif
+
+    fname[0] = '\0';
+    fuzz_cat(fname, sizeof fname, fuzzsnap.dir);
+    fuzz_cat(fname, sizeof fname, "/");
+    fuzz_cat(fname, sizeof fname, kind);
+    fuzz_cat(fname, sizeof fname, "-");
+    fuzz_catnum(fname, sizeof fname, h, 16, 16);
+    fuzz_cat(fname, sizeof fname, ".txt");
+    fd = open(fname, O_WRONLY | O_CREAT | O_EXCL, FCMASK);
+    if (fd >= 0) {
+        info[0] = '\0';
+        fuzz_cat(info, sizeof info, kind);
+        fuzz_cat(info, sizeof info, ": signal ");
+        fuzz_catnum(info, sizeof info, (uint64) sig, 10, 1);
+        fuzz_cat(info, sizeof info, "\nfrom ");
+        fuzz_cat(info, sizeof info, fuzzsnap.label);
+        fuzz_cat(info, sizeof info, " snapshot at T:");
+        fuzz_catnum(info, sizeof info, (uint64) fuzzsnap.startmoves, 10, 1);
+        fuzz_cat(info, sizeof info, ", failed at T:");
+        fuzz_catnum(info, sizeof info, (uint64) gm.moves, 10, 1);
+        fuzz_cat(info, sizeof info, "\n");
+        fuzz_cat(info, sizeof info, gd.dungeons[u.uz.dnum].dname);
+        fuzz_cat(info, sizeof info, ", depth ");
+        if ((dpth = depth(&u.uz)) < 0)
+            fuzz_cat(info, sizeof info, "-"), dpth = -dpth;
+        fuzz_catnum(info, sizeof info, (uint64) dpth, 10, 1);
+        fuzz_cat(info, sizeof info, "\n");
+        if (write(fd, info, strlen(info)) > 0) {
+#ifdef PANICTRACE_LIBC
+            backtrace_symbols_fd(bt, count, fd);
+#endif
+        }
+        (void) close(fd);
+    }
+    fuzz_unlink_levels();
+    _exit(exitcode);
+}
+
+/* record a failure in a worker unless it has been seen already; not
+   for use from a signal handler (see fuzz_signal() for that) */
+void
+fuzz_crash(const char *kind, const char *msg)
+{
+    char fname[BUFSZ];
+    uint64 h = hash_bytes(0, (genericptr_t) kind, strlen(kind));
+    FILE *fp;
+    int fd;
+#ifdef PANICTRACE_LIBC
+    void *bt[30];
+    char **info, *p;
+    int i, count;
+
+    count = backtrace(bt, SIZE(bt));
+    info = backtrace_symbols(bt, count);
+    /* hash the symbolic frames ("nethack(func+0x1f)"), not the absolute
+       addresses which follow them, so that the same call chain gets the
+       same name from one run of the program to the next */
+    for (i = 0; info && i < count; ++i) {
+        p = strstr(info[i], " [");
+        h = hash_bytes(h, (genericptr_t) info[i],
+                       p ? (size_t) (p - info[i]) : strlen(info[i]));
+    }
+    if (!info)
+#endif
+        /* no stack available; go by the message */
+        h = hash_bytes(h, (genericptr_t) msg, strlen(msg));
+
+    Snprintf(fname, sizeof fname, "%s/%s-%016llx.txt", fuzzsnap.dir, kind,
+             (unsigned long long) h);
+    fd = open(fname, O_WRONLY | O_CREAT | O_EXCL, FCMASK);
+    if (fd >= 0 && (fp = fdopen(fd, "w")) != 0) {
+        (void) fprintf(fp, "%s: %s\n", kind, msg);
+        (void) fprintf(fp, "from %s snapshot at T:%ld, failed at T:%ld\n",
+                       fuzzsnap.label, fuzzsnap.startmoves, gm.moves);
+        (void) fprintf(fp, "%s, depth %d\n",
+                       gd.dungeons[u.uz.dnum].dname, depth(&u.uz));
+#ifdef PANICTRACE_LIBC
+        for (i = 0; info && i < count; ++i)
+            (void) fprintf(fp, "[%02d] %s\n", i, info[i]);
+#endif
+        (void) fclose(fp);
+    } else if (fd >= 0) {
+        (void) close(fd);
+    }
+    fuzz_worker_done(!strcmp(kind, "hang") ? FUZZ_EXIT_HANG
+                                           : FUZZ_EXIT_CRASH);
+}
+#endif /* FUZZ_SNAPSHOTS */
+
 /*wizcmds.c*/
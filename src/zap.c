@@ -718,6 +718,7 @@ montraits(
         mtmp2->mhp = mtmp2->mhpmax;
         /* Get these ones from mtmp */
         mtmp2->minvent = mtmp->minvent; /*redundant*/
+        minvent_changed(mtmp2);
         /* monster ID is available if the monster died in the current
            game, but will be zero if the corpse was in a bones level
            (we cleared it when loading bones) */
@@ -1297,6 +1298,8 @@ cancel_item(struct obj *obj)
             }
             break;
         }
+        if (obj->otyp != otyp)
+            obj_retyped(obj);
     }
     /* cancelling a troll's corpse prevents it from reviving (on its own;
        does not affect undead turning induced revival) */
@@ -5111,7 +5114,8 @@ zap_over_floor(
                         else
                             lev->typ = HWALL;
                         fix_wall_spines(max(0,x-1), max(0,y-1),
-                                        min(COLNO,x+1), min(ROWNO,y+1));
+                                        min(COLNO-1,x+1), min(ROWNO-1,y+1));
+                        set_wall_state_area(x - 1, y - 1, x + 1, y + 1);
                     } else {
                         lev->typ = lava ? ROOM : ICE;
                     }
@@ -5394,6 +5398,7 @@ fracture_rock(struct obj *obj) /* no texts here! */
 
     obj->otyp = ROCK;
     obj->oclass = GEM_CLASS;
+    obj_retyped(obj);
     obj->quan = (long) rn1(60, 7);
     obj->owt = weight(obj);
     obj->dknown = obj->bknown = obj->rknown = 0;
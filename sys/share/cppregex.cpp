@@ -5,6 +5,7 @@
 
 #include <regex>
 #include <memory>
+#include <string>
 #include <cstring>
 
 extern "C" {
@@ -20,20 +21,27 @@ extern "C" { // rest of file
 
 extern const char regex_id[] = "cppregex";
 
+/* from hacklib.c; see posixregex.c */
+extern boolean regex_literal(const char *, char *, size_t);
+
 struct nhregex {
     std::unique_ptr<std::regex> re;
     std::unique_ptr<std::regex_error> err;
+    std::string lit; /* text every match contains */
+    bool litonly;    /* the pattern is just 'lit' */
 };
 
 struct nhregex *
 regex_init(void)
 {
-    return new nhregex;
+    return new nhregex();
 }
 
 boolean
 regex_compile(const char *s, struct nhregex *re)
 {
+    char litbuf[BUFSZ];
+
     if (!re)
         return FALSE;
     try {
@@ -41,6 +49,8 @@ regex_compile(const char *s, struct nhregex *re)
                                       | std::regex::nosubs
                                       | std::regex::optimize)));
         re->err.reset(nullptr);
+        re->litonly = regex_literal(s, litbuf, sizeof litbuf);
+        re->lit = litbuf;
         return TRUE;
     } catch (const std::regex_error& err) {
         re->err.reset(new std::regex_error(err));
@@ -70,6 +80,10 @@ regex_match(const char *s, struct nhregex *re)
 {
     if (!re->re)
         return false;
+    if (!re->lit.empty() && !std::strstr(s, re->lit.c_str()))
+        return false;
+    if (re->litonly)
+        return true;
     try {
         return regex_search(s, *re->re, std::regex_constants::match_any);
     } catch (const std::regex_error& err) {
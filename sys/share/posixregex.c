@@ -47,6 +47,12 @@
  * One possible error result is "out of memory" so freeing the failed
  * re should be done to try to recover memory before issuing any error
  * feedback.
+ *
+ * Implementations for POSIX extended regular expressions can use
+ * regex_literal() from hacklib.c to find text which any match has to
+ * contain, and try strstr() for that before running the regex engine.
+ * Most MSGTYPE and MENUCOLOR patterns are largely plain text, so that
+ * rules out nearly every string without the cost of a regex match.
  */
 
 const char regex_id[] = "posixregex";
@@ -54,21 +60,34 @@ const char regex_id[] = "posixregex";
 struct nhregex {
     regex_t re;
     int err;
+    char *lit;       /* text every match contains; Null if none */
+    boolean litonly; /* the pattern is just 'lit' */
 };
 
 struct nhregex *
 regex_init(void)
 {
-    return (struct nhregex *) alloc(sizeof (struct nhregex));
+    struct nhregex *re = (struct nhregex *) alloc(sizeof (struct nhregex));
+
+    re->lit = (char *) 0;
+    re->litonly = FALSE;
+    return re;
 }
 
 boolean
 regex_compile(const char *s, struct nhregex *re)
 {
+    char litbuf[BUFSZ];
+
     if (!re)
         return FALSE;
+    if (re->lit)
+        free((genericptr_t) re->lit), re->lit = (char *) 0;
     if ((re->err = regcomp(&re->re, s, REG_EXTENDED | REG_NOSUB)))
         return FALSE;
+    re->litonly = regex_literal(s, litbuf, sizeof litbuf);
+    if (*litbuf)
+        re->lit = dupstr(litbuf);
     return TRUE;
 }
 
@@ -95,6 +114,10 @@ regex_match(const char *s, struct nhregex *re)
 
     if (!re || !s)
         return FALSE;
+    if (re->lit && !strstr(s, re->lit))
+        return FALSE;
+    if (re->litonly)
+        return TRUE;
 
     if ((result = regexec(&re->re, s, 0, (genericptr_t) 0, 0))) {
         if (result != REG_NOMATCH)
@@ -108,6 +131,8 @@ void
 regex_free(struct nhregex *re)
 {
     regfree(&re->re);
+    if (re->lit)
+        free((genericptr_t) re->lit);
     free(re);
 }
 
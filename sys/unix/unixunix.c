@@ -377,6 +377,9 @@ child(int wt)
 #endif
 #ifdef __linux__
     linux_mapon();
+#endif
+#ifdef PREGEN_LEVELS
+    pregen_cancel(); /* wait() below would accept it in place of child */
 #endif
     if ((f = fork()) == 0) { /* child */
         (void) setgid(getgid());
@@ -0,0 +1,28 @@
+-- regex_match() checks rules for required literal text before running
+-- the regex engine; make sure that shortcut gives the same answers
+
+local regextests = {
+   { pat = "you hear", str = "You hear a noise. you hear it", result = true },
+   { pat = "you hear", str = "You hear a noise.", result = false },
+   { pat = "^You see", str = "You see here", result = true },
+   { pat = "^You see", str = "Now You see", result = false },
+   { pat = "a\\.b", str = "a.b", result = true },
+   { pat = "a\\.b", str = "axb", result = false },
+   { pat = "ab*c", str = "ac", result = true },
+   { pat = "foo|bar", str = "bar", result = true },
+   { pat = "gold pieces?", str = "1 gold piece", result = true },
+   -- word anchors are zero-width, not the literal characters < and >
+   { pat = "\\<foo\\>", str = "a foo b", result = true },
+   { pat = "\\<foo\\>", str = "a food b", result = false },
+   { pat = "\\<foo\\>", str = "<foo>", result = true },
+   { pat = "\\bfoo\\b", str = "a foo b", result = true },
+   { pat = "\\bfoo\\b", str = "afoo", result = false },
+};
+
+for k, v in pairs(regextests) do
+   local res = nh.regex_match(v.pat, v.str);
+   if res ~= v.result then
+      error(string.format("regex_match(\"%s\", \"%s\") returned %s",
+                          v.pat, v.str, tostring(res)));
+   end
+end
@@ -0,0 +1,240 @@
+/* NetHack 3.7	glyphids.c	*/
+/* Copyright (c) Michael Allison, 2021. */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * Build-time utility which writes src/glyphtab.c: every glyph's "G_"
+ * identifier in read-only storage, plus a perfect hash over them so
+ * that glyphs.c can look an identifier up without building the
+ * runtime glyphid cache (and allocating a copy of each of the 9000+
+ * names) whenever a config or symset file is read.
+ *
+ * The perfect hash uses the hash-and-displace scheme: the identifiers
+ * are first distributed into buckets using glyphid_hash(id, 0); then,
+ * largest bucket first, each bucket is given the smallest displacement
+ * d for which glyphid_hash(id, d) puts all of its members into slots
+ * not yet taken.  A lookup costs two hashes and a single strcmpi().
+ *
+ * Link with objects.o, and with hacklib for nh_snprintf().
+ */
+
+#include "hack.h"
+
+#ifdef Snprintf
+#undef Snprintf
+#endif
+#define Snprintf(str, size, ...) \
+    nh_snprintf(__func__, __LINE__, str, size, __VA_ARGS__)
+
+#ifdef MONITOR_HEAP
+/* we don't link with src/alloc.o; use the real free() */
+#undef free
+#endif
+
+#define Fprintf (void) fprintf
+
+#include "../src/glyphid.c"
+
+#ifdef AMIGA
+#define SOURCE_TEMPLATE "NH:src/%s"
+#else
+#ifdef MAC
+#define SOURCE_TEMPLATE ":src:%s"
+#else
+#define SOURCE_TEMPLATE "../src/%s"
+#endif
+#endif
+#define GLYPHTAB_FILE "glyphtab.c"
+
+int main(int, char **);
+
+static char *names[MAX_GLYPH];
+static int bucket_next[MAX_GLYPH];
+static int *bucket_head, *bucket_order, *bucket_size, *slot_taken;
+static unsigned short *displ;
+static short *slot;
+static unsigned nbuckets, nslots;
+
+staticfn int cmp_bucket_size(const genericptr, const genericptr);
+staticfn boolean place_bucket(int, unsigned, int);
+staticfn void make_table(void);
+staticfn void write_table(FILE *);
+
+staticfn int
+cmp_bucket_size(const genericptr a, const genericptr b)
+{
+    int ba = *(const int *) a, bb = *(const int *) b;
+
+    /* bigger buckets first; bucket number as tie-breaker keeps the
+       output the same from one build to the next */
+    if (bucket_size[ba] != bucket_size[bb])
+        return bucket_size[bb] - bucket_size[ba];
+    return ba - bb;
+}
+
+/* try displacement d for bucket b; on success, claim the slots */
+staticfn boolean
+place_bucket(int b, unsigned d, int pass)
+{
+    int glyph;
+    unsigned s;
+
+    for (glyph = bucket_head[b]; glyph >= 0; glyph = bucket_next[glyph]) {
+        s = glyphid_hash(names[glyph], d) & (nslots - 1);
+        /* slot_taken[] holds the pass number of tentative claims so
+           that two members of this bucket can't share a slot */
+        if (slot[s] >= 0 || slot_taken[s] == pass)
+            return FALSE;
+        slot_taken[s] = pass;
+    }
+    for (glyph = bucket_head[b]; glyph >= 0; glyph = bucket_next[glyph]) {
+        s = glyphid_hash(names[glyph], d) & (nslots - 1);
+        slot[s] = (short) glyph;
+    }
+    displ[b] = (unsigned short) d;
+    return TRUE;
+}
+
+staticfn void
+make_table(void)
+{
+    char buf[QBUFSZ];
+    int glyph, other, b, i, count = 0, pass = 0;
+    unsigned d;
+
+    for (glyph = 0; glyph < MAX_GLYPH; ++glyph) {
+        if (!glyphid_name(glyph, buf, sizeof buf))
+            continue;
+        names[glyph] = strcpy((char *) malloc(strlen(buf) + 1), buf);
+        ++count;
+    }
+    /* a load factor below 2/3 keeps the displacements small */
+    for (nslots = 1; nslots < (unsigned) count + count / 2; nslots <<= 1)
+        continue;
+    nbuckets = nslots / 4;
+
+    bucket_head = (int *) malloc(nbuckets * sizeof (int));
+    bucket_order = (int *) malloc(nbuckets * sizeof (int));
+    bucket_size = (int *) malloc(nbuckets * sizeof (int));
+    displ = (unsigned short *) malloc(nbuckets * sizeof (unsigned short));
+    slot_taken = (int *) malloc(nslots * sizeof (int));
+    slot = (short *) malloc(nslots * sizeof (short));
+    for (i = 0; i < (int) nbuckets; ++i) {
+        bucket_order[i] = i;
+        bucket_size[i] = 0;
+        bucket_head[i] = -1;
+        displ[i] = 0;
+    }
+    for (i = 0; i < (int) nslots; ++i) {
+        slot_taken[i] = 0;
+        slot[i] = -1;
+    }
+
+    for (glyph = MAX_GLYPH - 1; glyph >= 0; --glyph) {
+        if (!names[glyph])
+            continue;
+        b = (int) (glyphid_hash(names[glyph], 0) & (nbuckets - 1));
+        bucket_next[glyph] = bucket_head[b];
+        bucket_head[b] = glyph;
+        ++bucket_size[b];
+    }
+    /* identical ids hash to the same bucket; only the lowest glyph
+       is reachable by name, same as with the runtime cache */
+    for (b = 0; b < (int) nbuckets; ++b) {
+        for (glyph = bucket_head[b]; glyph >= 0;
+             glyph = bucket_next[glyph]) {
+            for (i = glyph; (other = bucket_next[i]) >= 0; ) {
+                if (!strcmpi(names[glyph], names[other])) {
+                    bucket_next[i] = bucket_next[other];
+                    --bucket_size[b];
+                } else {
+                    i = other;
+                }
+            }
+        }
+    }
+
+    qsort((genericptr_t) bucket_order, nbuckets, sizeof (int),
+          cmp_bucket_size);
+    for (i = 0; i < (int) nbuckets; ++i) {
+        b = bucket_order[i];
+        if (!bucket_size[b])
+            break;
+        for (d = 1; d <= 0xffff; ++d)
+            if (place_bucket(b, d, ++pass))
+                break;
+        if (d > 0xffff) {
+            Fprintf(stderr, "glyphids: no displacement for bucket %d.\n", b);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+staticfn void
+write_table(FILE *ofp)
+{
+    int glyph;
+    unsigned i;
+
+    Fprintf(ofp,
+            "/* This file is automatically generated.  Do not edit. */\n");
+    Fprintf(ofp, "\n/* #included by glyphs.c; see util/glyphids.c */\n");
+    Fprintf(ofp, "\n#define GLYPHID_COUNT %d\n", MAX_GLYPH);
+    Fprintf(ofp, "#define GLYPHID_BUCKETS %u\n", nbuckets);
+    Fprintf(ofp, "#define GLYPHID_SLOTS %u\n", nslots);
+
+    Fprintf(ofp, "\nstatic const char *const glyphid_names[%s] = {\n",
+            "GLYPHID_COUNT");
+    for (glyph = 0; glyph < MAX_GLYPH; ++glyph) {
+        if (names[glyph])
+            Fprintf(ofp, "    \"%s\", /* %04d */\n", names[glyph], glyph);
+        else
+            Fprintf(ofp, "    (const char *) 0, /* %04d */\n", glyph);
+    }
+    Fprintf(ofp, "};\n");
+
+    Fprintf(ofp, "\nstatic const unsigned short %s[GLYPHID_BUCKETS] = {",
+            "glyphid_disp");
+    for (i = 0; i < nbuckets; ++i)
+        Fprintf(ofp, "%s%5u,", !(i % 10) ? "\n   " : "", displ[i]);
+    Fprintf(ofp, "\n};\n");
+
+    Fprintf(ofp, "\nstatic const short glyphid_slot[GLYPHID_SLOTS] = {");
+    for (i = 0; i < nslots; ++i)
+        Fprintf(ofp, "%s%5d,", !(i % 10) ? "\n   " : "", slot[i]);
+    Fprintf(ofp, "\n};\n");
+    Fprintf(ofp, "\n/*glyphtab.c*/\n");
+}
+
+int
+main(int argc UNUSED, char *argv[] UNUSED)
+{
+    char filename[30];
+    FILE *ofp;
+    int glyph;
+
+    objects_globals_init();
+    make_table();
+
+    Snprintf(filename, sizeof filename, SOURCE_TEMPLATE, GLYPHTAB_FILE);
+    if (!(ofp = fopen(filename, "w"))) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    write_table(ofp);
+    (void) fclose(ofp);
+
+    for (glyph = 0; glyph < MAX_GLYPH; ++glyph)
+        free(names[glyph]);
+    free(bucket_head);
+    free(bucket_order);
+    free(bucket_size);
+    free(displ);
+    free(slot_taken);
+    free(slot);
+    exit(EXIT_SUCCESS);
+    /*NOTREACHED*/
+    return 0;
+}
+
+/*glyphids.c*/
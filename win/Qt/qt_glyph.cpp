@@ -249,16 +249,15 @@ void NetHackQtGlyphs::setSize(int w, int h)
     if (!w || !h)
 	return; // Still not decided
 
-    if (size == pm1.size()) { // not zoomed
-	pm = pm1;
-	return;
-    }
-    if (size == pm2.size()) { // zoomed
-	pm = pm2;
+    // toggling zoom or changing the tile size back and forth reuses the
+    // tile set already scaled for that size instead of rescaling it
+    int key = (w << 16) | h;
+    QMap<int, QPixmap>::const_iterator it = scaled_pm.constFind(key);
+    if (it != scaled_pm.constEnd()) {
+	pm = it.value();
 	return;
     }
 
-    bool was1 = (size == pm1.size());
     if (w == tilefile_tile_W && h == tilefile_tile_H) {
 	pm.convertFromImage(img);
     } else {
@@ -272,7 +271,11 @@ void NetHackQtGlyphs::setSize(int w, int h)
 	pm.convertFromImage(scaled, Qt::ThresholdDither | Qt::PreferDither);
 	QApplication::restoreOverrideCursor();
     }
-    (was1 ? pm2 : pm1) = pm;
+    // a few sizes is plenty for zooming; don't keep every intermediate
+    // size seen while the tile size settings are being adjusted
+    if (scaled_pm.size() >= 4)
+	scaled_pm.clear();
+    scaled_pm.insert(key, pm);
 }
 
 } // namespace nethack_qt_
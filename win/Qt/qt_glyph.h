@@ -38,7 +38,8 @@ public:
 
 private:
 	QImage img;
-	QPixmap pm,pm1, pm2;
+	QPixmap pm;
+	QMap<int, QPixmap> scaled_pm; // tile set at each recently used size
 	QSize size;
 	int tiles_per_row;
         //QTransform *mirrormatrix;
@@ -164,20 +164,23 @@ void NetHackQtMapViewport::SetupTextmapFont(QPainter &painter)
     rogue_font = new QFont(fontfamily, pts - 1);
 }
 
-void NetHackQtMapViewport::paintEvent(QPaintEvent* event)
+// draw the map cells in "cells" into the backing store; paintEvent() copies
+// from there to the screen, so unchanged cells are never re-rendered
+void NetHackQtMapViewport::RenderCells(const QRect &cells)
 {
     NetHackQtGlyphs &glyphs = qt_settings->glyphs();
     int gW = glyphs.width(),
         gH = glyphs.height();
-    QRect area = event->rect();
-    QRect garea;
-    garea.setCoords(std::max(0, area.left() / gW),
-                    std::max(0, area.top() / gH),
-                    std::min(COLNO - 1, area.right() / gW),
-                    std::min(ROWNO - 1, area.bottom() / gH));
+    QRect garea = cells & QRect(0, 0, COLNO, ROWNO);
+    QRect area(garea.x() * gW, garea.y() * gH,
+               garea.width() * gW, garea.height() * gH);
+
+    if (backing.isNull() || garea.isEmpty())
+        return; // first paintEvent() will render everything
 
     QPainter painter;
-    painter.begin(this);
+    painter.begin(&backing);
+    painter.fillRect(area, Qt::black);
 
     unsigned special, tileidx;
     uint32 color;
@@ -186,8 +189,7 @@ void NetHackQtMapViewport::paintEvent(QPaintEvent* event)
     if (Is_rogue_level(&u.uz) || iflags.wc_ascii_map) {
 	// You enter a VERY primitive world!
 
-	painter.setClipRect( event->rect() ); // (normally we don't clip)
-	painter.fillRect( event->rect(), Qt::black );
+	painter.setClipRect(area); // (normally we don't clip)
 
 	if (!rogue_font)
             SetupTextmapFont(painter);
@@ -265,6 +267,40 @@ void NetHackQtMapViewport::paintEvent(QPaintEvent* event)
 	}
     }
 
+    painter.end();
+}
+
+void NetHackQtMapViewport::paintEvent(QPaintEvent* event)
+{
+    NetHackQtGlyphs &glyphs = qt_settings->glyphs();
+    int gW = glyphs.width(),
+        gH = glyphs.height();
+    QRect area = event->rect();
+    QRect garea;
+    garea.setCoords(std::max(0, area.left() / gW),
+                    std::max(0, area.top() / gH),
+                    std::min(COLNO - 1, area.right() / gW),
+                    std::min(ROWNO - 1, area.bottom() / gH));
+
+    // the backing store is kept at the screen's resolution so that
+    // HiDPI displays don't get an upscaled (blurry) map
+    qreal dpr = devicePixelRatioF();
+    QSize bsize(qRound(COLNO * gW * dpr), qRound(ROWNO * gH * dpr));
+    if (backing.size() != bsize || backing.devicePixelRatio() != dpr) {
+        // first time, tile size has changed, or the window has moved to
+        // a screen with a different pixel ratio; render the whole map
+        backing = QPixmap(bsize);
+        backing.setDevicePixelRatio(dpr);
+        RenderCells(QRect(0, 0, COLNO, ROWNO));
+    }
+
+    QPainter painter;
+    painter.begin(this);
+    // source rectangle is in the pixmap's device pixels
+    painter.drawPixmap(QRectF(area), backing,
+                       QRectF(area.x() * dpr, area.y() * dpr,
+                              area.width() * dpr, area.height() * dpr));
+
     if (garea.contains(cursor)) {
 	if (Is_rogue_level(&u.uz)) {
 	    painter.setPen( Qt::white );
@@ -501,6 +537,7 @@ void NetHackQtMapViewport::updateTiles()
     change.clear();
     change.add(0, 0, COLNO, ROWNO);
     delete rogue_font; rogue_font = NULL;
+    backing = QPixmap(); // re-rendered at the new size by paintEvent()
 }
 
 QSize NetHackQtMapViewport::sizeHint() const
@@ -553,10 +590,14 @@ void NetHackQtMapViewport::Display(bool block)
     int gW = qt_settings->glyphs().width(),
         gH = qt_settings->glyphs().height();
 
+    // bring the backing store up to date, then let Qt repaint the
+    // affected parts of the window when it next gets to its event loop;
+    // several Display() calls in a row get merged into one paint
     for (int i = 0; i < change.clusters(); i++) {
 	const QRect& chg = change[i];
-	repaint(chg.x() * gW, chg.y() * gH,
-                chg.width() * gW, chg.height() * gH);
+        RenderCells(chg);
+	update(chg.x() * gW, chg.y() * gH,
+               chg.width() * gW, chg.height() * gH);
     }
     change.clear();
 
@@ -57,6 +57,7 @@ private:
         QPoint cursor;
         QPixmap pet_annotation;
         QPixmap pile_annotation;
+        QPixmap backing; // rendered map cells; cursor is drawn on top
         NetHackQtClickBuffer &clicksink;
         Clusterizer change;
 
@@ -68,6 +69,7 @@ private:
 	void Changed(int x, int y);
 	void updateTiles();
         void SetupTextmapFont(QPainter &painter);
+        void RenderCells(const QRect &garea);
 
 	// NetHackQtMapWindow2 passes through many calls to the viewport
 	friend class NetHackQtMapWindow2;
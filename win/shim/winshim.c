@@ -191,11 +191,13 @@ shim_ctrl_nhwindow(
     return (win_request_info *) 0;
 }
 #else /* !__EMSCRIPTEN__ */
-VDECLCB(shim_update_inventory,(int a1 UNUSED)
-DECLB(win_request_info *, shim_ctrl_nhwindow,
+VDECLCB(shim_update_inventory,(int a1), "vi", A2P a1)
+/* the callback accepts a request by storing 'wri' in *ret_ptr; see
+   sys/libnh/README.md */
+DECLCB(win_request_info *, shim_ctrl_nhwindow,
     (winid window, int request, win_request_info *wri),
-    "viip",
-    A2P window UNUSED, A2P request UNUSED, P2V wri UNUSED)
+    "piip",
+    A2P window, A2P request, P2V wri)
 #endif
 
 /* Interface definition used in windows.c */
@@ -212,7 +214,14 @@ struct window_procs shim_procs = {
      | WC2_HILITE_STATUS | WC2_HITPOINTBAR | WC2_FLUSH_STATUS
      | WC2_RESET_STATUS
 #endif
-     | WC2_DARKGRAY | WC2_SUPPRESS_HIST | WC2_STATUSLINES),
+     | WC2_DARKGRAY | WC2_SUPPRESS_HIST | WC2_STATUSLINES
+#ifndef __EMSCRIPTEN__
+     /* the embedding program may take anim_frame requests; if its
+        ctrl_nhwindow() returns null, delay_output() is used instead
+        (the JavaScript glue can't return a pointer, so not for WASM) */
+     | WC2_ANIMFRAMES
+#endif
+     ),
     {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},   /* color availability */
     shim_init_nhwindows, shim_player_selection, shim_askname, shim_get_nh_event,
     shim_exit_nhwindows, shim_suspend_nhwindows, shim_resume_nhwindows,